@@ -24,6 +24,12 @@
 #define SPI_CMD_SHOW_OVERLAY 0x30
 #define SPI_CMD_USER_CONFIG 0x40
 #define SPI_CMD_INPUT_EVENT 0x41
+#define SPI_CMD_SAVE_UI 0x60
+#define SPI_CMD_GET_UI_IMAGE 0x61
+
+/* GET_UI_IMAGE / SAVE_UI flags (shared with slave) */
+#define UI_IMAGE_FLAG_RESTORED 0x01u
+#define UI_IMAGE_FLAG_STORED 0x02u
 
 /* JSON flags (shared with slave) */
 #define JSON_FLAG_HEAD 0x01u
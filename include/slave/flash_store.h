@@ -0,0 +1,43 @@
+/**
+ * @file flash_store.h
+ * @brief Page-granular store in program flash (holds the persisted UI image).
+ *
+ * The store is a page-aligned constant region linked into the firmware image, so the linker
+ * keeps code out of it; flashing new firmware erases it. Host builds (UNIT_TEST/UI_MEMCALC)
+ * back it with RAM.
+ */
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** CH32V003 fast erase/program page. */
+#define FLASH_STORE_PAGE_SIZE 64u
+
+/* Reserved bytes, whole pages: the UI image header, a full 768-byte arena and a string table. */
+#ifndef FLASH_STORE_SIZE
+#define FLASH_STORE_SIZE 1024u
+#endif
+#if (FLASH_STORE_SIZE % FLASH_STORE_PAGE_SIZE) != 0
+#error "FLASH_STORE_SIZE must be a whole number of pages"
+#endif
+
+/** First byte of the store (FLASH_STORE_SIZE bytes); erased bytes read 0xFF. */
+const uint8_t* flash_store_data(void);
+/**
+ * Erase one page and program it.
+ * @param off   Page-aligned offset inside the store.
+ * @param words FLASH_STORE_PAGE_SIZE bytes of page content.
+ * @return RES_OK, or RES_RANGE for an offset outside the store.
+ */
+int flash_store_write_page(uint16_t off, const uint32_t* words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLASH_STORE_H */
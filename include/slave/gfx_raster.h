@@ -0,0 +1,35 @@
+/**
+ * @file gfx_raster.h
+ * @brief Raster operations on the shared tile buffer (one 8px page at a time).
+ *
+ * Coordinates are panel pixels; page_top is the first row of the page currently held
+ * in the shared buffer (page * 8). Shapes are clipped to the panel width and to that
+ * page once per call, so each touched column is a single masked byte operation.
+ */
+#ifndef GFX_RASTER_H
+#define GFX_RASTER_H
+
+#include <stdint.h>
+
+#include "gfx_shared.h"
+
+/** Set (color != 0) or clear the pixels of a w x h rectangle. */
+void gfx_fill_rect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top, uint8_t color);
+/** XOR the pixels of a w x h rectangle. */
+void gfx_invert_rect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top);
+/** Draw a horizontal line of w pixels starting at (x, y). */
+void gfx_hline(int16_t x, int16_t y, uint8_t w, uint8_t page_top, uint8_t color);
+/** Draw a vertical line of h pixels starting at (x, y). */
+void gfx_vline(int16_t x, int16_t y, uint8_t h, uint8_t page_top, uint8_t color);
+/**
+ * OR a 1-bpp bitmap into the page.
+ * Layout matches the panel: ceil(h / 8) rows of w column bytes, LSB = top pixel.
+ */
+void gfx_blit_bitmap(int16_t        x,
+                     int16_t        y,
+                     const uint8_t* bitmap,
+                     uint8_t        w,
+                     uint8_t        h,
+                     uint8_t        page_top);
+
+#endif /* GFX_RASTER_H */
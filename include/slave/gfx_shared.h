@@ -9,9 +9,38 @@
 
 #include "gfx_font.h"
 
-/** Get pointer to the shared 128-byte tile buffer. */
+/** Width of the shared tile buffer in columns (one byte per column). */
+#define GFX_TILE_WIDTH 128
+/** Height of one tile/page in pixels. */
+#define GFX_PAGE_HEIGHT 8
+#ifndef GFX_TILE_HEADROOM
+/** Bytes reserved in front of the shared tile buffer so a transport can prepend its
+ *  framing in place (the SSD1306 single-transaction page stream needs 13). */
+#define GFX_TILE_HEADROOM 13
+#endif
+#ifndef GFX_TILE_BUFFERS
+/** Tile buffers (1 or 2). With 2 the SSD1306 driver builds the next page in one buffer
+ *  while the other streams; each extra buffer costs GFX_TILE_HEADROOM + 128 bytes of RAM. */
+#define GFX_TILE_BUFFERS 1
+#endif
+
+/** Get pointer to the shared 128-byte tile buffer (GFX_TILE_HEADROOM bytes precede it). */
 uint8_t* gfx_get_shared_buffer(void);
 /** Zero the contents of the shared tile buffer. */
 void gfx_clear_shared_buffer(void);
+#if GFX_TILE_BUFFERS > 1
+/** Make the other tile buffer the shared one; the previous one keeps its contents. */
+void gfx_swap_shared_buffer(void);
+#endif
+/**
+ * Draw text into the tile for page_top, clipped to rows [clip_top, clip_bottom].
+ * x may be negative (columns left of the panel are skipped).
+ */
+void gfx_draw_text_clipped(int16_t     x,
+                           int16_t     pixel_y,
+                           const char* text,
+                           uint8_t     clip_top,
+                           uint8_t     clip_bottom,
+                           uint8_t     page_top);
 
 #endif /* GFX_SHARED_H */
@@ -56,16 +56,28 @@ i2c_err_t i2c_init(i2c_device_t* dev);
 
 /**
  * @brief Write raw data to I2C device using DMA for large transfers
+ *        Non-blocking: queues START and returns; the I2C event interrupt sends the address
+ *        and enables the DMA channel. Safe to call from the done hook.
  * @param dev Device configuration
- * @param buf Data buffer to write
+ * @param buf Data buffer to write (must stay valid until the done hook runs)
  * @param len Number of bytes to write
- * @return i2c_err_t status
+ * @return i2c_err_t status, I2C_ERR_BUSY while a transfer is still in progress
  */
 i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len);
 /**
  * @brief Query if current TX DMA transfer is still in progress (non-blocking)
- * @return 1 while DMA active, 0 when idle
+ * @return 1 from i2c_write_raw_dma() until the done hook runs, 0 when idle
  */
 int i2c_tx_dma_busy(void);
+/**
+ * @brief Register a hook run from the transfer interrupts once a transfer has finished
+ *        (STOP issued, i2c_tx_dma_busy() reads 0).
+ *        The hook runs in interrupt context and may start the next transfer with
+ *        i2c_write_raw_dma().
+ * @param callback Hook to run with I2C_OK (transfer complete), I2C_ERR_NACK (address or
+ *                 data not acknowledged) or I2C_ERR_BERR (bus or DMA transfer error), or
+ *                 NULL for none
+ */
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status));
 
 #endif  // I2C_CUSTOM_H
@@ -24,6 +24,22 @@
 #define SSD1306_PAGE_HEIGHT 8
 /* Full-frame size varies with height (pages). Query via ssd1306_framebuffer_size(). */
 
+#ifndef SSD1306_STREAM_SINGLE_XFER
+/* 1 = each damaged page goes out as one I2C transaction: the address-window commands
+   (each behind a Co=1 control byte) and the page bytes behind a single 0x40 control byte,
+   sent by DMA straight from the shared tile buffer. 0 = address commands, then 28-byte
+   data chunks, each its own transaction. */
+#define SSD1306_STREAM_SINGLE_XFER 1
+#endif
+
+#ifndef SSD1306_XFER_IRQ_CHAIN
+/* 1 = the transfer-complete interrupt launches the next chunk, finishes the page and, with
+   two tile buffers and SSD1306_STREAM_SINGLE_XFER, starts the page already built in the
+   other buffer, so the main loop only builds tiles. 0 = ssd1306_async_process() polls the
+   DMA and starts every transfer. */
+#define SSD1306_XFER_IRQ_CHAIN 1
+#endif
+
 /** Basic color constants. */
 #define BLACK 0
 #define WHITE 1
@@ -93,6 +109,37 @@ int ssd1306_write_page(uint8_t page, const uint8_t* data);
  * The supplied callback is the same form as ssd1306_render_tiles.
  */
 int ssd1306_render_async_begin(void (*render_callback)(uint8_t tile_y));
+/** \brief Register a hook run once at the start of every async frame.
+ * Called from ssd1306_render_async_begin() and when a coalesced rerender restarts
+ * at page 0, before the first page callback and before the frame latches its damage
+ * and start line, so invalidations and ssd1306_scroll_lines() calls made by the hook
+ * apply to that frame. The UI layer uses it to sample animations and resolve the
+ * per-frame display list so page callbacks only walk intersecting entries.
+ * Pass NULL to disable.
+ */
+void ssd1306_render_async_set_frame_callback(void (*frame_callback)(void));
+/** \brief Mark a page/column rectangle as damaged for the next async frame.
+ * Damage accumulates until a frame starts; that frame rebuilds only damaged pages
+ * and streams only the union column window [col_first, col_last]. A frame that
+ * starts with no recorded damage redraws the whole panel.
+ */
+void ssd1306_invalidate_region(uint8_t page_first,
+                               uint8_t page_last,
+                               uint8_t col_first,
+                               uint8_t col_last);
+/** \brief Mark the whole panel as damaged for the next async frame. */
+void ssd1306_invalidate_all(void);
+/** \brief Move the panel image up by dy rows (down when negative) without redrawing it.
+ * Shifts the display start line (0x40-0x7F) for the next frame and damages only the
+ * rows the shift exposes. The caller guarantees everything on the panel moved by dy.
+ * The register is written once that frame has streamed the exposed rows.
+ */
+void ssd1306_scroll_lines(int8_t dy);
+/** \brief Start line the current frame is rendered for.
+ * Panel row y is held in GDDRAM row (y + start line) & 63; the page callback receives
+ * GDDRAM page indices (0-7) and maps them back to panel rows with this value.
+ */
+uint8_t ssd1306_frame_start_line(void);
 /** \brief Progress asynchronous transfer state machine.
  * Call frequently in main loop to feed next chunks when DMA becomes idle. */
 void ssd1306_render_async_process(void);
@@ -136,6 +183,31 @@ int ssd1306_dma_xfer_active(void);
 /** Return current async stage (ADDR/BUILD/STREAM_START/STREAMING). Idle returns 0xFF. */
 uint8_t ssd1306_get_render_stage(void);
 
+#ifndef SSD1306_PERF_STATS
+/* 1 = time page builds and page transfers with SysTick for ssd1306_perf_read(); 0 = off */
+#define SSD1306_PERF_STATS 1
+#endif
+
+/** Render/transfer counters for the window since the previous ssd1306_perf_read(). */
+typedef struct {
+  uint32_t build_sum_us;  /**< Total page callback time */
+  uint32_t stream_sum_us; /**< Total time from page address to last byte on the bus */
+  uint32_t window_ms;     /**< Window length (filled by ssd1306_perf_read) */
+  uint16_t build_min_us;  /**< Fastest page callback (0 when builds == 0) */
+  uint16_t build_max_us;  /**< Slowest page callback */
+  uint16_t builds;        /**< Pages built */
+  uint16_t stream_min_us; /**< Fastest page transfer (0 when streams == 0) */
+  uint16_t stream_max_us; /**< Slowest page transfer */
+  uint16_t streams;       /**< Pages transferred (pages whose checksum matched are not sent) */
+  uint16_t frames;        /**< Frames completed */
+  uint16_t coalesced;     /**< Rerender requests folded into an already pending rerender */
+} ssd1306_perf_t;
+
+/** \brief Copy the counters into out and start a new window.
+ *  Times come from SysTick->CNT. Returns RES_BAD_STATE when SSD1306_PERF_STATS is 0.
+ */
+int ssd1306_perf_read(ssd1306_perf_t* out);
+
 /** \brief Get current display height in pixels (32 or 64). */
 uint8_t ssd1306_height(void);
 /** \brief Get current number of 8px-tall pages (4 or 8). */
@@ -0,0 +1,41 @@
+/**
+ * @file ui_anim.h
+ * @brief Time-based sampling of the screen slide, list scroll and edit blink.
+ *
+ * Each animation records its start time; its position is evaluated from the elapsed
+ * get_system_time_ms() when a frame is about to be built. Motion therefore keeps its
+ * wall-clock speed when frames take longer than PROTOCOL_ANIM_FRAME_MS to reach the
+ * panel, and the positions in between are skipped instead of queued.
+ */
+#ifndef UI_ANIM_H
+#define UI_ANIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Q8 fixed-point 1.0 (end of an eased animation). */
+#define UI_ANIM_Q8_ONE 256u
+
+#ifndef UI_ANIM_EASING
+/* 1 = smoothstep easing for slides and list scrolls; 0 = linear */
+#define UI_ANIM_EASING 1
+#endif
+
+/** Return eased progress in Q8 (0..UI_ANIM_Q8_ONE) after elapsed_ms of duration_ms. */
+uint16_t ui_anim_ease_q8(uint16_t elapsed_ms, uint16_t duration_ms);
+/**
+ * Advance every running animation to now_ms and damage what moved.
+ * Only call between frames: a start-line list step shifts the image of the last frame.
+ */
+void ui_anim_sample(uint16_t now_ms);
+/** Sample animations for the frame being started (called from the frame-start hook). */
+void ui_anim_frame_begin(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UI_ANIM_H */
@@ -0,0 +1,32 @@
+/**
+ * @file ui_edit.h
+ * @brief Post-COMMIT structural edits: append child, remove subtree (text resize lives in
+ *        ui_runtime).
+ *
+ * Element ids stay in pre-order: an appended child takes the id after its parent's subtree and a
+ * removed subtree closes its id range, so the ids match a fresh provisioning of the edited UI.
+ */
+#ifndef UI_EDIT_H
+#define UI_EDIT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Prepare a post-COMMIT create (drops the list row tables); returns the pre-order flag. */
+uint8_t ui_edit_begin(void);
+/**
+ * Finish a post-COMMIT create started with ui_edit_begin(): move the new element (id first_new)
+ * behind its parent's subtree when the tree was pre-order, then rebuild the tables.
+ */
+void ui_edit_place_created(uint8_t first_new, uint8_t preorder);
+/** Remove eid and its descendants; needs the pre-order index (RES_BAD_STATE otherwise). */
+int ui_edit_remove_subtree(uint8_t eid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UI_EDIT_H */
@@ -11,7 +11,13 @@
 extern "C" {
 #endif
 
+/** Visibility of an element under the current navigation state (cached bitset lookup). */
 uint8_t protocol_is_element_visible(uint8_t element_id);
+/**
+ * Mark the visibility bitset stale; call after changing nav depth/stack, the active screen,
+ * the screen slide state or the element tree. The next query recomputes every element.
+ */
+void protocol_invalidate_visibility(void);
 void protocol_register_local_screen(uint8_t screen_id, uint8_t owner_text);
 uint8_t protocol_text_local_screen(uint8_t text_id);
 
@@ -0,0 +1,63 @@
+/**
+ * @file ui_persist.h
+ * @brief Committed UI image in flash: save after provisioning, restore at boot.
+ *
+ * The image is the used part of the shared arena (per-element tables, attributes, runtime
+ * nodes and list row tables) plus the few protocol counters that describe it, behind a header
+ * with a format version and two FNV-1a hashes: one over the image (integrity) and one over the
+ * JSON objects that built the UI (identity). The host computes the second one over the objects
+ * it would send and skips provisioning when the restored image reports the same value.
+ *
+ * Static texts (created without a capacity) move into a string table at the front of the image
+ * when it is saved; their arena entries shrink to a flash reference, so RAM is freed for
+ * appends after COMMIT. Updating such a text brings its RAM entry back.
+ */
+#ifndef UI_PERSIST_H
+#define UI_PERSIST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Flash-resident UI image. 0 drops the image commands, the boot restore and the flash store. */
+#ifndef UI_PERSIST
+#define UI_PERSIST 1
+#endif
+
+/** Image format; bump when the arena layout or the header changes. */
+#define UI_PERSIST_VERSION 5u
+
+/* FNV-1a, 32 bit (the multiply is spelled as shifts: the core has no multiplier) */
+#define UI_PERSIST_HASH_INIT 0x811C9DC5u
+
+/* UI_GET_IMAGE flags */
+#define UI_IMAGE_FLAG_RESTORED 0x01u /**< Current UI came from flash (cleared by a JSON HEAD). */
+#define UI_IMAGE_FLAG_STORED 0x02u   /**< Flash holds a valid image. */
+
+/** Fold len bytes into an FNV-1a hash. */
+uint32_t ui_persist_hash(uint32_t hash, const uint8_t* data, uint16_t len);
+/** Fold one applied JSON object (bytes as received) into the UI hash; HEAD starts a new UI. */
+void ui_persist_note_object(const char* buf, uint8_t len, uint8_t flags);
+/**
+ * Write the current UI to flash. Call right after COMMIT so runtime nodes hold their defaults.
+ * @return RES_OK; RES_BAD_STATE before the first COMMIT or when built without UI_PERSIST;
+ *         RES_NO_SPACE when the image does not fit the flash store.
+ */
+int ui_persist_save(void);
+/**
+ * Replace the protocol state with the image in flash and request a render.
+ * @return RES_OK; RES_BAD_STATE when no valid image for this build is stored.
+ */
+int ui_persist_restore(void);
+/** Report UI_IMAGE_FLAG_* and the hash of the current UI (0 when none was provisioned). */
+uint8_t ui_persist_info(uint32_t* ui_hash);
+/** Text at off in the flash string table (UI_ATTR_TAG_TEXT_FLASH entries). */
+const char* ui_persist_string(uint16_t off);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UI_PERSIST_H */
@@ -9,6 +9,10 @@
 #ifndef SCREEN_ANIM_PIXELS_PER_FRAME
 #define SCREEN_ANIM_PIXELS_PER_FRAME 8 /* 128px / 8px = 16 frames (~250ms @16ms frame) */
 #endif
+#ifndef SCREEN_ANIM_DURATION_MS
+/* Slide duration; the offset is sampled from elapsed time when each frame starts. */
+#define SCREEN_ANIM_DURATION_MS ((128 / SCREEN_ANIM_PIXELS_PER_FRAME) * PROTOCOL_ANIM_FRAME_MS)
+#endif
 
 
 /**
@@ -20,6 +24,7 @@ typedef struct {
   uint8_t to_screen;   /**< Destination screen ordinal */
   int16_t offset_px;   /**< Accumulated offset in pixels (0..128) */
   int8_t  dir;         /**< +1 = slide left (next screen enters from right), -1 = slide right */
+  uint16_t start_ms;   /**< Low 16 bits of get_system_time_ms() when the slide started */
 } screen_anim_state_t;
 
 #ifdef __cplusplus
@@ -49,12 +54,17 @@ extern "C" {
 #define SPI_CMD_GET_STATUS 0x20
 #define SPI_CMD_SCROLL_TO_SCREEN 0x21
 #define SPI_CMD_GET_ELEMENT_STATE 0x22
+/* Render/transfer counters since the previous read (see ssd1306_perf_t) */
+#define SPI_CMD_GET_PERF 0x23
 /* Overlay screen control (was popup): payload [screen_id,(dur_lo,dur_hi,flags optional)] */
 #define SPI_CMD_SHOW_OVERLAY 0x30
 /* Input events */
 #define SPI_CMD_INPUT_EVENT 0x41
 /* Power management */
 #define SPI_CMD_GOTO_STANDBY 0x50
+/* Flash-resident UI image (see ui_persist.h) */
+#define SPI_CMD_SAVE_UI 0x60
+#define SPI_CMD_GET_UI_IMAGE 0x61
 /* Debug utilities */
 
 /* Limits */
@@ -108,6 +118,11 @@ typedef enum {
 #define NAV_STACK_MAX_DEPTH 4u
 #endif
 
+/* Base screens a UI may define: size of the ordinal -> element id table (1 byte each). */
+#ifndef UI_MAX_SCREENS
+#define UI_MAX_SCREENS 8u
+#endif
+
 /** @brief Stack entry used to restore state when unwinding nested navigation. */
 typedef struct {
   uint8_t type;               /**< nav_context_type_t discriminator. */
@@ -138,6 +153,10 @@ typedef struct {
 void protocol_service_deferred_ops(void);
 /** Request a render; safe to call from ISR (sets a flag only). */
 void protocol_request_render(void);
+/** Request a render limited to the panel area drawn by one element (pages + columns). */
+void protocol_request_render_element(uint8_t element_id);
+/** Scroll a list drawn alone on the panel by dy rows through the display start line. */
+void protocol_scroll_list_lines(uint8_t list_id, int8_t dy);
 void protocol_overlay_cleared(void);
 void ui_spi_rx_irq(void);
 
@@ -149,9 +168,35 @@ typedef struct {
   uint8_t              element_count;
   uint8_t              element_capacity; /**< Allocated capacity for per-element tables. */
   element_t*           elements;         /**< Per-element parent/type table (shared arena). */
+#if UI_ATTR_TEXT_INDEX
+  uint16_t*            text_attr_off;    /**< Arena offset of each TEXT attribute (0 = none). */
+#endif
   /* Absolute positions per element (x,y). Stored in shared arena. */
   uint8_t*             pos_x;
   uint8_t*             pos_y;
+  /* Child links per element in creation order (INVALID_ELEMENT_ID terminates). Shared arena. */
+  uint8_t*             first_child;
+  uint8_t*             next_sibling;
+#if UI_SCREEN_CACHE
+  /* Screen ownership per element, resolved at creation: nearest SCREEN (self included)
+     and top-level SCREEN (parentless root of the chain). Shared arena. */
+  uint8_t*             root_screen;
+  uint8_t*             top_screen;
+#endif
+  /* Base screen ordinal per element id, 0xFF when not a base screen; filled as base screens
+     are created. Shared arena. */
+  uint8_t*             screen_ords;
+  /* Base screen element id per ordinal (< screen_count), the inverse of screen_ords. */
+  uint8_t              screen_ids[UI_MAX_SCREENS];
+  /* Runtime node slot per element (see UR_SLOT_UNIT, 0 = none). Shared arena. */
+  uint8_t*             runtime_slot;
+  /* Visibility bitset, one bit per element (LSB first). Shared arena. */
+  uint8_t*             visible_bits;
+#if UI_SUBTREE_INDEX
+  /* One past the last descendant per element, valid while preorder is set. Shared arena. */
+  uint8_t*             subtree_end;
+#endif
+  uint8_t              preorder; /**< Non-zero while every subtree is a contiguous id range. */
   int16_t              scroll_x;
   uint8_t              initialized;
   uint8_t              status_dirty; /**< Non-zero when an element changed since last GET_STATUS. */
@@ -173,10 +218,11 @@ typedef struct {
    * screens. */
   uint8_t nav_depth;
   screen_anim_state_t screen_anim; /**< Horizontal screen slide animation state */
+  uint8_t             visible_valid; /**< Non-zero while visible_bits matches nav/screen state */
   /* Edit blink state for visual feedback during editing */
   uint8_t             edit_blink_active;  /**< Non-zero when blink is active */
   uint8_t             edit_blink_phase;   /**< Current blink phase (0=dim, 1=bright) */
-  uint8_t             edit_blink_counter; /**< Frame counter for blink timing */
+  uint16_t            edit_blink_start_ms; /**< Low 16 bits of the time the current phase began */
   uint8_t             header_seen;        /**< Non-zero after header element is parsed (header is required). */
 } protocol_state_t;
 
@@ -228,12 +274,18 @@ int cmd_get_status(uint8_t* payload, uint8_t length);
 int cmd_scroll_to_screen(uint8_t* payload, uint8_t length);
 /** Query element state for host synchronization. */
 int cmd_get_element_state(uint8_t* payload, uint8_t length);
+/** Report render/transfer counters and start a new measurement window. */
+int cmd_get_perf(uint8_t* payload, uint8_t length);
 /** Show overlay screen with optional duration and input mask. */
 int cmd_show_overlay(uint8_t* payload, uint8_t length);
 /** Inject input event from host. */
 int cmd_input_event(uint8_t* payload, uint8_t length);
 /** Enter standby upon host request (no response sent). */
 int cmd_goto_standby(uint8_t* payload, uint8_t length);
+/** Write the committed UI to flash, then answer like GET_UI_IMAGE. */
+int cmd_save_ui(uint8_t* payload, uint8_t length);
+/** Report whether the UI came from flash and the hash of the JSON objects that built it. */
+int cmd_get_ui_image(uint8_t* payload, uint8_t length);
 /* Unified JSON command (flags + single element JSON object) */
 /** Process a compact JSON element update (single object). */
 int cmd_json(uint8_t* p, uint8_t l);
@@ -254,7 +306,7 @@ int protocol_apply_json_object(const char* buf, uint8_t len, uint8_t flags);
 #define STATUS_FLAG_OVERLAY 0x04u
 /** Mark an element as changed for GET_STATUS dirty reporting. */
 void protocol_element_changed(uint8_t element_id);
-/** Advance easing + list scroll animations; call every main loop iteration. */
+/** Run the overlay countdown and request animation frames; call every main loop iteration. */
 void protocol_tick_animations(void);
 /** Check if barrel element is currently being edited. */
 uint8_t barrel_is_editing(uint8_t element_id);
@@ -264,8 +316,16 @@ uint8_t protocol_element_capacity(void);
 uint8_t protocol_screen_role(uint8_t element_id);
 
 /** Render a whole screen immediately. */
-/** Render a single 8px-high tile row (called by async driver). */
+/** Render one GDDRAM page (called by async driver; honours the display start line). */
 void render_screen_tile(uint8_t tile_y);
+/** Resolve the display list from the current animation state, without advancing it. */
+void render_frame_resolve(void);
+/** Sample animations, then resolve the display list (async frame-start hook). */
+void render_frame_begin(void);
+/** Draw the 8 panel rows starting at row_top (any alignment) into the shared buffer. */
+void render_screen_rows(uint8_t row_top);
+/** Return 1 when the last frame drew nothing but list_id (start-line scroll is safe). */
+uint8_t render_list_owns_panel(uint8_t list_id);
 extern protocol_state_t g_protocol_state;
 extern volatile uint8_t g_rx_path;
 /** Set to 1 by cmd_goto_standby; polled by main loop to perform display_off and standby. */
@@ -292,6 +352,8 @@ uint8_t protocol_is_element_visible(uint8_t element_id);
 /* Auto-popup hooks are not used in the overlay model. */
 /** Reset full protocol state to defaults. */
 void protocol_reset_state(void);
+/** Reserve the per-element tables for capacity elements in the arena head (header "n"). */
+int protocol_reserve_element_storage(uint8_t capacity);
 /* Response helpers */
 /** Send a response frame for a command. */
 int     protocol_send_response(uint8_t cmd, const uint8_t* payload, uint8_t len);
@@ -305,9 +367,20 @@ uint8_t protocol_map_result_to_rc(int r);
 #ifndef LIST_ANIM_PIXELS_PER_FRAME
 #define LIST_ANIM_PIXELS_PER_FRAME 1 /* rows are 8px high; 8 frames per row scroll */
 #endif
+#ifndef LIST_ANIM_DURATION_MS
+/* One-row list scroll duration (frames at the baseline rate that reach the panel in time). */
+#define LIST_ANIM_DURATION_MS ((8 / LIST_ANIM_PIXELS_PER_FRAME) * PROTOCOL_ANIM_FRAME_MS)
+#endif
+#ifndef LIST_ANIM_START_LINE_SCROLL
+/* 1 = a list drawn alone on the panel scrolls by moving the SSD1306 display start line and
+   only the rows entering or leaving its window are redrawn; 0 = every step redraws the list.
+   Works with any UI_DISPLAY_LIST_CAP: without room in the display list the sole-list check
+   resolves the elements again. */
+#define LIST_ANIM_START_LINE_SCROLL 1
+#endif
 /* Edit blink timing */
-#ifndef EDIT_BLINK_PERIOD_FRAMES
-#define EDIT_BLINK_PERIOD_FRAMES 30 /* ~500ms at 60fps for blink cycle */
+#ifndef EDIT_BLINK_PHASE_MS
+#define EDIT_BLINK_PHASE_MS 480 /* time each blink phase is held */
 #endif
 
 #ifdef __cplusplus
@@ -26,12 +26,40 @@ extern "C" {
 #define UI_ATTR_ARENA_CAP 768u
 #endif
 
+/* Per-element text attribute offsets (2 bytes per element in the arena head) so text lookups
+   skip the attribute scan. 0 keeps the plain linear-scan layout (ADR 0005). */
+#ifndef UI_ATTR_TEXT_INDEX
+#define UI_ATTR_TEXT_INDEX 1
+#endif
+
+/* Owning screens per element (root_screen and top_screen, 2 bytes per element in the arena
+   head) so layout, rendering and visibility skip the parent walk. 0 walks parent ids. */
+#ifndef UI_SCREEN_CACHE
+#define UI_SCREEN_CACHE 1
+#endif
+
+/* Pre-order subtree index (subtree_end, 1 byte per element in the arena head): while
+   provisioning stays in pre-order, is_descendant_of() is a range check and
+   element_subtree_end() a lookup. 0 walks parent ids and scans the range instead. */
+#ifndef UI_SUBTREE_INDEX
+#define UI_SUBTREE_INDEX 1
+#endif
+
+/* Post-COMMIT structural edits (append child, remove subtree, resize text; see ui_edit.h).
+   0 keeps the arena append-only after COMMIT (ADR 0003). */
+#ifndef UI_STRUCT_EDIT
+#define UI_STRUCT_EDIT 1
+#endif
+
 /* Attribute tags. */
 typedef enum {
-  UI_ATTR_TAG_TEXT        = 0x10, /* len + bytes */
-  UI_ATTR_TAG_SCREEN_ROLE = 0x11  /* role byte */
+  UI_ATTR_TAG_TEXT       = 0x10, /* len + bytes */
+  UI_ATTR_TAG_TEXT_FLASH = 0x11  /* len + string table offset (text lives in the flash image) */
 } ui_attr_tag_t;
 
+/** Either form of a text attribute. */
+#define UI_ATTR_IS_TEXT(tag) (((tag) & 0xFEu) == UI_ATTR_TAG_TEXT)
+
 /* -------------------------------------------------------------------------- */
 /* Entry struct representations (packed)                                      */
 /* These provide a readable mapping for code reviewers without altering the  */
@@ -51,19 +79,26 @@ typedef enum {
 typedef struct UI_ATTR_PACKED {
   uint8_t tag;        /**< UI_ATTR_TAG_TEXT */
   uint8_t element_id; /**< Owning element id */
-  uint8_t len;        /**< Allocated payload size in bytes INCLUDING NUL terminator (>=1) */
+  uint8_t len;        /**< Allocated payload size in bytes INCLUDING NUL terminator (>=1), plus UI_ATTR_TEXT_STATIC */
   uint8_t data[];     /**< Flexible array (size-1 bytes for text, followed by at least one NUL) */
 } ui_attr_text_entry_t;
 
+/* len byte of text entries: size in the low bits, bit 7 set for texts created without a
+   capacity (static labels, which a save may move to the flash string table). */
+#define UI_ATTR_TEXT_SIZE_MASK 0x3Fu
+#define UI_ATTR_TEXT_STATIC    0x80u
+
 typedef struct UI_ATTR_PACKED {
-  uint8_t tag;        /**< UI_ATTR_TAG_SCREEN_ROLE */
-  uint8_t element_id; /**< Owning screen element id */
-  uint8_t role;       /**< overlay_role_t value */
-} ui_attr_screen_role_entry_t;
+  uint8_t tag;        /**< UI_ATTR_TAG_TEXT_FLASH */
+  uint8_t element_id; /**< Owning element id */
+  uint8_t len;        /**< Size of the RAM entry it replaced (restored on the next update) */
+  uint8_t str_lo;     /**< Offset in the flash string table, low byte */
+  uint8_t str_hi;     /**< Offset in the flash string table, high byte */
+} ui_attr_text_flash_entry_t;
 
 /* Size helper macros for skip logic (text remains variable). */
 #define UI_ATTR_SIZE_TEXT_HDR        ((uint16_t)3u) /* tag + element_id + len */
-#define UI_ATTR_SIZE_SCREEN_ROLE     ((uint16_t)3u) /* tag + element_id + role */
+#define UI_ATTR_SIZE_TEXT_FLASH      ((uint16_t)5u) /* tag + element_id + len + offset */
 
 /** Compact element reference: parent id and type (packed). */
 typedef struct {
@@ -97,24 +132,22 @@ typedef struct ui_runtime_t {
   uint16_t head_used;            /**< Bytes consumed from arena head by tables/attributes */
   uint16_t used_tail;            /**< Bytes consumed from arena tail by runtime nodes */
   uint16_t attr_base;            /**< Offset to first attribute entry within arena */
-  /* Linked list heads (offsets from base) */
-  ur_off_t triggers_head_off;    /**< Head of trigger linked list (offset) */
-  ur_off_t lists_head_off;       /**< Head of list-state linked list */
-  ur_off_t barrels_head_off;     /**< Head of barrel-state linked list */
   uint8_t  arena[UI_ATTR_ARENA_CAP]; /**< Shared arena storage */
 } ui_runtime_t;
 
-/** Trigger node stored in arena; next is offset (little endian). */
+/* Runtime nodes start on UR_SLOT_UNIT boundaries counted from the arena end; an element's
+   8-bit slot (protocol_state_t.runtime_slot) is that distance in units, 0 = no node. */
+#define UR_SLOT_UNIT 4u
+#if (UI_ATTR_ARENA_CAP % UR_SLOT_UNIT) != 0 || (UI_ATTR_ARENA_CAP / UR_SLOT_UNIT) > 255
+#error "UI_ATTR_ARENA_CAP must be a multiple of UR_SLOT_UNIT and at most 255 units"
+#endif
+
+/** Trigger runtime state. */
 typedef struct {
   uint8_t element_id;
   uint8_t version;
 } ur_trigger_state_t;
 
-typedef struct {
-  uint16_t          next_off; /* 0 = null */
-  ur_trigger_state_t st;      /* element_id + version */
-} ur_trigger_node_t;
-
 /* ---------------- List View runtime ---------------- */
 typedef struct {
   uint8_t element_id;  /**< owning list element id */
@@ -123,17 +156,15 @@ typedef struct {
   uint8_t visible_rows;/**< desired rows (1..6/8 depending on height) */
   uint8_t anim_active; /**< non-zero while animating */
   int8_t  anim_dir;    /**< -1 up, +1 down, 0 none */
-  uint8_t anim_pix;    /**< 0..8 progress */
+  uint8_t anim_pix;    /**< 0..8 pixels shown so far (sampled from elapsed time) */
   uint8_t pending_top; /**< target after anim */
   uint8_t pending_cursor; /**< target after anim */
   uint8_t last_text_child; /**< Most recent TEXT child id during provisioning */
+  uint8_t row_count;   /**< Entries in the row table (valid when rows_off != 0) */
+  uint16_t rows_off;   /**< Arena offset of the row -> TEXT element id table built at COMMIT (0 = none) */
+  uint16_t anim_start_ms; /**< Low 16 bits of get_system_time_ms() when the row scroll started */
 } ur_list_state_t;
 
-typedef struct {
-  uint16_t        next_off; /* 0 = null */
-  ur_list_state_t st;
-} ur_list_node_t;
-
 /* ---------------- Barrel runtime ---------------- */
 typedef struct {
   uint8_t element_id; /**< owning barrel element id */
@@ -141,11 +172,6 @@ typedef struct {
   int16_t value;      /**< selection index */
 } ur_barrel_state_t;
 
-typedef struct {
-  uint16_t          next_off; /* 0 = null */
-  ur_barrel_state_t st;
-} ur_barrel_node_t;
-
 /* Small helpers (implemented in ui_runtime.c) */
 void ur_init(ui_runtime_t* rt);
 void* ur__ptr(ui_runtime_t* rt, ur_off_t off);
@@ -163,8 +189,33 @@ ur_list_state_t* ur_list_get_or_add(ui_runtime_t* rt, uint8_t element_id);
 ur_barrel_state_t* ur_barrel_find(ui_runtime_t* rt, uint8_t element_id);
 ur_barrel_state_t* ur_barrel_get_or_add(ui_runtime_t* rt, uint8_t element_id);
 
+/* ---------------- Structural edits ---------------- */
+/** Element id remap of one structural edit; ids keep pre-order like an array insert/erase. */
+typedef struct {
+  uint8_t op; /**< UR_REMAP_* */
+  uint8_t a;  /**< REMOVE: first removed id; MOVE: destination id */
+  uint8_t b;  /**< REMOVE: one past the last removed id; MOVE: source id (>= a) */
+} ur_remap_t;
+
+enum {
+  UR_REMAP_NONE   = 0, /**< ids unchanged */
+  UR_REMAP_REMOVE = 1, /**< ids [a, b) dropped, later ids shift down */
+  UR_REMAP_MOVE   = 2, /**< id b moves to a, ids [a, b) shift up by one */
+};
+
+/** New id of an element under a remap (UR_INVALID_ELEMENT_ID when it was removed). */
+uint8_t ur_remap_id(const ur_remap_t* m, uint8_t element_id);
+/**
+ * Pack the runtime nodes against the arena end through the slot table and drop the list row
+ * tables (rebuild them with list_build_row_tables()). Node owner ids are rewritten from the
+ * slot table, so it may already be remapped.
+ */
+void ur_compact(ui_runtime_t* rt);
+
 /* ---------------- Attribute helpers (head allocation) ---------------- */
 uint16_t ui_attr_get_memory_usage(ui_runtime_t* rt);
+/** Renumber attribute entries under a remap, dropping (and closing the gaps of) removed ones. */
+void ui_attr_remap(ui_runtime_t* rt, const ur_remap_t* m);
 int ui_attr_store_text_with_cap(ui_runtime_t* rt,
                                 uint8_t       element_id,
                                 const char*   text,
@@ -172,9 +223,21 @@ int ui_attr_store_text_with_cap(ui_runtime_t* rt,
 int ui_attr_store_text(ui_runtime_t* rt, uint8_t element_id, const char* text);
 const char* ui_attr_get_text(ui_runtime_t* rt, uint8_t element_id);
 int ui_attr_update_text(ui_runtime_t* rt, uint8_t element_id, const char* new_text);
-
-int ui_attr_store_screen_role(ui_runtime_t* rt, uint8_t element_id, uint8_t role);
-int ui_attr_get_screen_role(ui_runtime_t* rt, uint8_t element_id, uint8_t* out_role);
+/**
+ * Reallocate a text attribute with a new capacity (0 = text length) and store text in it; the
+ * old entry is closed up. text must not point into the arena.
+ */
+int ui_attr_resize_text(ui_runtime_t* rt, uint8_t element_id, const char* text, uint8_t capacity);
+/**
+ * Static texts a save moves to the flash string table (NUL-terminated, in arena order).
+ * @param freed Arena bytes their flash references give back.
+ * @return String table bytes they need.
+ */
+uint16_t ui_attr_static_text_bytes(ui_runtime_t* rt, uint16_t* freed);
+/** Byte k of the string table laid out by ui_attr_static_text_bytes(). */
+uint8_t ui_attr_static_text_byte(ui_runtime_t* rt, uint16_t k);
+/** Replace those texts by references to the table once it is written at str_off. */
+void ui_attr_flash_static_texts(ui_runtime_t* rt, uint16_t str_off);
 
 int ui_attr_store_position(ui_runtime_t* rt,
                            uint8_t       element_id,
@@ -11,14 +11,44 @@
 extern "C" {
 #endif
 
+/** Set the parent of eid and append it to the parent's child chain (unlinks a previous parent). */
+void element_set_parent(uint8_t eid, uint8_t parent);
+/**
+ * Rebuild child links, screen ownership, base screen ordinals and the pre-order flag from the
+ * parent table and the base screen markers in screen_ords (after a structural edit).
+ */
+void element_rebuild_tables(void);
+/**
+ * Iterate the children of parent with the given type in creation order: pass
+ * INVALID_ELEMENT_ID as prev for the first; returns INVALID_ELEMENT_ID after the last.
+ */
+uint8_t element_next_child(uint8_t parent, uint8_t prev, uint8_t type);
+/**
+ * One past the last id that can be in eid's subtree: exact when provisioning was pre-order,
+ * element_count otherwise. Descendants always have larger ids than their ancestors.
+ */
+uint8_t element_subtree_end(uint8_t eid);
+/** One past the last id of eid's subtree among ids below limit, which must be in pre-order. */
+uint8_t element_range_end(uint8_t eid, uint8_t limit);
+/** Build the per-list row -> TEXT element id tables in the arena tail (called at COMMIT). */
+void list_build_row_tables(void);
+/** Return a list's row table (NULL when not built) and its length via out_count. */
+const uint8_t* list_row_table(uint8_t list_eid, uint8_t* out_count);
 uint8_t list_item_count(uint8_t list_eid);
+/** Return the TEXT element id of a row, ignoring visibility (INVALID_ELEMENT_ID if out of range). */
+uint8_t list_item_by_index(uint8_t list_eid, uint8_t row_index);
 uint8_t list_row_count(uint8_t list_eid);
 uint8_t list_child_by_index(uint8_t list_eid, uint8_t row_index);
 uint8_t list_row_index_of_text(uint8_t list_eid, uint8_t text_eid);
 uint8_t text_inline_barrel_id(uint8_t text_eid);
 uint8_t element_parent_list(uint8_t eid);
+/** Nearest SCREEN of eid, eid itself when it is a screen (cached with UI_SCREEN_CACHE). */
 uint8_t element_root_screen(uint8_t eid);
+/** Top-level (parentless) SCREEN that eid belongs to (cached with UI_SCREEN_CACHE). */
+uint8_t element_top_screen(uint8_t eid);
+/** Base screen element id for an ordinal, 0xFF if out of range (table lookup). */
 uint8_t find_screen_id_by_ordinal(uint8_t sord);
+/** Ordinal of a base screen element, 0xFF for overlays, local screens and non-screens. */
 uint8_t find_screen_ordinal_by_id(uint8_t screen_id);
 uint8_t is_descendant_of(uint8_t eid, uint8_t ancestor);
 
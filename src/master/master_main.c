@@ -169,6 +169,37 @@ static int master_read_status(MasterStatus* out)
   return (out->rc == 0u) ? 0 : (int) out->rc;
 }
 
+/**
+ * @brief Execute GET_UI_IMAGE (or SAVE_UI, which answers the same way) and parse the response.
+ * @param cmd SPI_CMD_GET_UI_IMAGE or SPI_CMD_SAVE_UI.
+ * @param out_flags Receives UI_IMAGE_FLAG_* bits.
+ * @param out_hash Receives the hash of the JSON objects behind the slave's current UI.
+ * @return 0 on success, non-zero on RC or protocol error.
+ */
+static int master_read_ui_image(uint8_t cmd, uint8_t* out_flags, uint32_t* out_hash)
+{
+  uint8_t resp[8] = {0};
+  uint8_t rlen    = (uint8_t) sizeof(resp);
+  int     r       = master_send_command(cmd, (const uint8_t*) 0, 0, resp, &rlen);
+  if ((r < 6) || (rlen < 6)) {
+    return -1;
+  }
+  *out_flags = resp[1];
+  *out_hash  = (uint32_t) resp[2] | ((uint32_t) resp[3] << 8) | ((uint32_t) resp[4] << 16) |
+              ((uint32_t) resp[5] << 24);
+  return (resp[0] == 0u) ? 0 : (int) resp[0];
+}
+
+/** Fold len bytes into an FNV-1a hash (same hash the slave keeps over received JSON objects). */
+static uint32_t master_ui_hash(uint32_t hash, const char* data, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    hash ^= (uint8_t) data[i];
+    hash += (hash << 1) + (hash << 4) + (hash << 7) + (hash << 8) + (hash << 24);
+  }
+  return hash;
+}
+
 /**
  * @brief Execute GET_ELEMENT_STATE for a given element id.
  * @param eid Element id to query.
@@ -364,12 +395,17 @@ static inline int master_show_overlay_rc(uint8_t screen_id, uint16_t duration_ms
  * - Intermediate objects: no flags
  *
  * Safety limits: objects larger than 120 bytes are skipped to avoid buffer overflow.
+ *
+ * @param json Concatenated objects.
+ * @param send 0 only hashes the objects that would be sent.
+ * @return FNV-1a hash of the sent object bytes, as GET_UI_IMAGE reports it afterwards.
  */
-static void send_combined_elements(const char* json)
+static uint32_t send_combined_elements(const char* json, uint8_t send)
 {
   const char* p     = json;
   const char* end   = p + strlen((const char*) json);
   int         index = 0;
+  uint32_t    hash  = 0x811C9DC5u;
   while (p < end) {
     while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
       p++;
@@ -428,14 +464,18 @@ static void send_combined_elements(const char* json)
     if (!more) {
       flags |= JSON_FLAG_COMMIT;
     }
-    uint8_t buf[1 + 96];
-    buf[0] = flags;
-    memcpy(&buf[1], obj_start, olen);
-    send_simple(SPI_CMD_JSON, buf, (uint8_t) (1 + olen));
-    delay_ms(10);
+    hash = master_ui_hash(hash, obj_start, olen);
+    if (send) {
+      uint8_t buf[1 + 96];
+      buf[0] = flags;
+      memcpy(&buf[1], obj_start, olen);
+      send_simple(SPI_CMD_JSON, buf, (uint8_t) (1 + olen));
+      delay_ms(10);
+    }
     index++;
     p = q;
   }
+  return hash;
 }
 
 /** Send a single JSON object with explicit flags; returns RC. */
@@ -580,9 +620,19 @@ int main(void)
     if (!ok) {}
     /* proceed even if PING not confirmed to keep previous behavior */
   }
-  /* 2) Provision elements for this scenario using header-provided demo JSON */
+  /* 2) Provision elements for this scenario using header-provided demo JSON, unless the slave
+   *    restored exactly this UI from flash at boot; a fresh provisioning is saved for next time */
   delay_ms(100);
-  send_combined_elements(demo_json_multi_flat);
+  {
+    uint32_t ui_hash     = send_combined_elements(demo_json_multi_flat, 0u);
+    uint8_t  image_flags = 0u;
+    uint32_t image_hash  = 0u;
+    if (master_read_ui_image(SPI_CMD_GET_UI_IMAGE, &image_flags, &image_hash) != 0 ||
+        (image_flags & UI_IMAGE_FLAG_RESTORED) == 0u || image_hash != ui_hash) {
+      (void) send_combined_elements(demo_json_multi_flat, 1u);
+      (void) master_read_ui_image(SPI_CMD_SAVE_UI, &image_flags, &image_hash);
+    }
+  }
   delay_ms(1000);
   /* 4) Periodic GET_STATUS */
 #if MASTER_ENABLE_LOCAL_BUTTONS
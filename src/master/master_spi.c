@@ -251,8 +251,10 @@ int master_send_command(uint8_t        cmd,
   master_spi_xfer(txbuf, total_len, NULL, 0);
 
   /* Allow slave time to process command and prepare response. Some commands (e.g. USER_CONFIG)
-   * clear the entire display and take longer. Use a slightly larger pre-poll delay for it. */
-  if (cmd == SPI_CMD_USER_CONFIG) {
+   * clear the entire display and take longer. Use a slightly larger pre-poll delay for it.
+   * SAVE_UI programs flash pages before it answers. */
+  uint8_t slow = (cmd == SPI_CMD_USER_CONFIG || cmd == SPI_CMD_SAVE_UI) ? 1u : 0u;
+  if (slow) {
     delay_ms(10);
   } else {
     delay_ms(2);
@@ -262,7 +264,7 @@ int master_send_command(uint8_t        cmd,
   uint8_t  hdr[3]     = {0};
   uint8_t  first_byte = 0;
   /* Poll for SYNC0 with bounded retries. Longer window for USER_CONFIG to cover display clear. */
-  uint16_t max_polls = (cmd == SPI_CMD_USER_CONFIG) ? 3000u : 400u; /* ~120ms / ~16ms @40us step */
+  uint16_t max_polls = slow ? 3000u : 400u; /* ~120ms / ~16ms @40us step */
   for (uint16_t tries = 0; tries < max_polls; ++tries) {
     first_byte = xfer_byte(0xFF);
     if (first_byte == SPI_RESP_SYNC0) {
@@ -0,0 +1,115 @@
+/**
+ * @file flash_store.c
+ * @brief Page-granular flash store on the CH32V003 fast page erase/program path.
+ *
+ * A page is erased (FTER) and then programmed from the 64-byte page buffer, loaded one word
+ * at a time through the target addresses (FTPG + BUFLOAD). Code runs from the same flash, so
+ * the core stalls while an operation is busy; the whole write takes a few milliseconds per page.
+ */
+#include "flash_store.h"
+
+#include <string.h>
+
+#include "ch32fun.h"
+#include "status_codes.h"
+
+#if defined(UNIT_TEST) || defined(UI_MEMCALC)
+
+/* Host builds: a RAM page array that starts erased */
+static uint8_t g_flash_store[FLASH_STORE_SIZE];
+static uint8_t g_flash_store_ready;
+
+const uint8_t* flash_store_data(void)
+{
+  if (g_flash_store_ready == 0u) {
+    memset(g_flash_store, 0xFF, sizeof(g_flash_store));
+    g_flash_store_ready = 1u;
+  }
+  return g_flash_store;
+}
+
+int flash_store_write_page(uint16_t off, const uint32_t* words)
+{
+  if ((off % FLASH_STORE_PAGE_SIZE) != 0u || off >= FLASH_STORE_SIZE) {
+    return RES_RANGE;
+  }
+  (void) flash_store_data();
+  memcpy(&g_flash_store[off], words, FLASH_STORE_PAGE_SIZE);
+  return RES_OK;
+}
+
+#else
+
+// Unlock keys (FLASH_KEYR, FLASH_MODEKEYR)
+#define FLASH_STORE_KEY1 0x45670123u
+#define FLASH_STORE_KEY2 0xCDEF89ABu
+
+// FLASH_CTLR bits (from Reference Manual)
+#define FLASH_STORE_CTLR_STRT (1u << 6)     // Start the selected operation
+#define FLASH_STORE_CTLR_LOCK (1u << 7)     // Lock the controller
+#define FLASH_STORE_CTLR_FLOCK (1u << 15)   // Lock fast page mode
+#define FLASH_STORE_CTLR_FTPG (1u << 16)    // Fast page program
+#define FLASH_STORE_CTLR_FTER (1u << 17)    // Fast page erase
+#define FLASH_STORE_CTLR_BUFLOAD (1u << 18) // Load the latched word into the page buffer
+#define FLASH_STORE_CTLR_BUFRST (1u << 19)  // Clear the page buffer
+
+// FLASH_STATR bits
+#define FLASH_STORE_STATR_BSY (1u << 0)
+
+/* Whole pages of erased flash, linked like any other constant */
+static const uint8_t g_flash_store[FLASH_STORE_SIZE]
+  __attribute__((aligned(FLASH_STORE_PAGE_SIZE))) = {[0 ... FLASH_STORE_SIZE - 1] = 0xFFu};
+
+/** Store base hidden from the optimizer, which would otherwise fold reads to the 0xFF image. */
+static const uint8_t* flash_store_base(void)
+{
+  const uint8_t* base = g_flash_store;
+  __asm__ volatile("" : "+r"(base));
+  return base;
+}
+
+/** Wait for the controller to finish the running operation. */
+static void flash_store_wait(void)
+{
+  while (FLASH->STATR & FLASH_STORE_STATR_BSY) {
+  }
+}
+
+const uint8_t* flash_store_data(void)
+{
+  return flash_store_base();
+}
+
+int flash_store_write_page(uint16_t off, const uint32_t* words)
+{
+  if ((off % FLASH_STORE_PAGE_SIZE) != 0u || off >= FLASH_STORE_SIZE) {
+    return RES_RANGE;
+  }
+  uint32_t           addr = (uint32_t) (uintptr_t) (flash_store_base() + off);
+  volatile uint32_t* dst  = (volatile uint32_t*) (uintptr_t) addr;
+  FLASH->KEYR             = FLASH_STORE_KEY1;
+  FLASH->KEYR             = FLASH_STORE_KEY2;
+  FLASH->MODEKEYR         = FLASH_STORE_KEY1;
+  FLASH->MODEKEYR         = FLASH_STORE_KEY2;
+  /* Erase */
+  FLASH->CTLR = FLASH_STORE_CTLR_FTER;
+  FLASH->ADDR = addr;
+  FLASH->CTLR = FLASH_STORE_CTLR_FTER | FLASH_STORE_CTLR_STRT;
+  flash_store_wait();
+  /* Fill the page buffer, then program it in one go */
+  FLASH->CTLR = FLASH_STORE_CTLR_FTPG;
+  FLASH->CTLR = FLASH_STORE_CTLR_FTPG | FLASH_STORE_CTLR_BUFRST;
+  flash_store_wait();
+  for (uint8_t i = 0; i < FLASH_STORE_PAGE_SIZE / 4u; i++) {
+    dst[i]      = words[i];
+    FLASH->CTLR = FLASH_STORE_CTLR_FTPG | FLASH_STORE_CTLR_BUFLOAD;
+    flash_store_wait();
+  }
+  FLASH->ADDR = addr;
+  FLASH->CTLR = FLASH_STORE_CTLR_FTPG | FLASH_STORE_CTLR_STRT;
+  flash_store_wait();
+  FLASH->CTLR = FLASH_STORE_CTLR_LOCK | FLASH_STORE_CTLR_FLOCK;
+  return RES_OK;
+}
+
+#endif
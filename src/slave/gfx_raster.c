@@ -0,0 +1,145 @@
+/**
+ * @file gfx_raster.c
+ * @brief Raster operations on the shared tile buffer with span-level clipping.
+ */
+#include "gfx_raster.h"
+
+#include <stddef.h>
+
+/* Raster op applied with a constant page mask */
+enum {
+  GFX_OP_CLEAR  = 0,
+  GFX_OP_SET    = 1,
+  GFX_OP_INVERT = 2,
+};
+
+/**
+ * Clip rows [y, y + h) to the page and columns [x, x + w) to the panel.
+ * Returns the row mask (0 when nothing is visible) and the column span.
+ */
+static uint8_t gfx_clip_span(int16_t  x,
+                             int16_t  y,
+                             uint8_t  w,
+                             uint8_t  h,
+                             uint8_t  page_top,
+                             uint8_t* out_x0,
+                             uint8_t* out_x1)
+{
+  if (w == 0u || h == 0u) {
+    return 0u;
+  }
+  int16_t top    = (y > (int16_t) page_top) ? y : (int16_t) page_top;
+  int16_t bottom = (int16_t) (y + h - 1);
+  if (bottom > (int16_t) (page_top + GFX_PAGE_HEIGHT - 1)) {
+    bottom = (int16_t) (page_top + GFX_PAGE_HEIGHT - 1);
+  }
+  if (top > bottom) {
+    return 0u;
+  }
+  int16_t x0 = (x < 0) ? 0 : x;
+  int16_t x1 = (int16_t) (x + w - 1);
+  if (x1 >= GFX_TILE_WIDTH) {
+    x1 = GFX_TILE_WIDTH - 1;
+  }
+  if (x0 > x1) {
+    return 0u;
+  }
+  *out_x0 = (uint8_t) x0;
+  *out_x1 = (uint8_t) x1;
+  return (uint8_t) ((0xFFu >> (7 - (bottom - page_top))) & (0xFFu << (top - page_top)));
+}
+
+/** Apply one raster op with a constant mask over a clipped rectangle. */
+static void gfx_rect_op(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top, uint8_t op)
+{
+  uint8_t x0   = 0u;
+  uint8_t x1   = 0u;
+  uint8_t mask = gfx_clip_span(x, y, w, h, page_top, &x0, &x1);
+  if (mask == 0u) {
+    return;
+  }
+  uint8_t* buf = gfx_get_shared_buffer();
+  if (op == GFX_OP_INVERT) {
+    for (uint8_t cx = x0; cx <= x1; cx++) {
+      buf[cx] ^= mask;
+    }
+  } else if (op == GFX_OP_SET) {
+    for (uint8_t cx = x0; cx <= x1; cx++) {
+      buf[cx] |= mask;
+    }
+  } else {
+    uint8_t keep = (uint8_t) ~mask;
+    for (uint8_t cx = x0; cx <= x1; cx++) {
+      buf[cx] &= keep;
+    }
+  }
+}
+
+void gfx_fill_rect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top, uint8_t color)
+{
+  gfx_rect_op(x, y, w, h, page_top, color ? GFX_OP_SET : GFX_OP_CLEAR);
+}
+
+void gfx_invert_rect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top)
+{
+  gfx_rect_op(x, y, w, h, page_top, GFX_OP_INVERT);
+}
+
+void gfx_hline(int16_t x, int16_t y, uint8_t w, uint8_t page_top, uint8_t color)
+{
+  gfx_rect_op(x, y, w, 1u, page_top, color ? GFX_OP_SET : GFX_OP_CLEAR);
+}
+
+void gfx_vline(int16_t x, int16_t y, uint8_t h, uint8_t page_top, uint8_t color)
+{
+  gfx_rect_op(x, y, 1u, h, page_top, color ? GFX_OP_SET : GFX_OP_CLEAR);
+}
+
+void gfx_blit_bitmap(int16_t        x,
+                     int16_t        y,
+                     const uint8_t* bitmap,
+                     uint8_t        w,
+                     uint8_t        h,
+                     uint8_t        page_top)
+{
+  if (!bitmap) {
+    return;
+  }
+  uint8_t x0   = 0u;
+  uint8_t x1   = 0u;
+  uint8_t mask = gfx_clip_span(x, y, w, h, page_top, &x0, &x1);
+  if (mask == 0u) {
+    return;
+  }
+  /* Source rows feeding this page: one byte, or two when not page-aligned */
+  uint8_t        src_pages = (uint8_t) ((h + 7u) / 8u);
+  int16_t        d         = (int16_t) ((int16_t) page_top - y);
+  const uint8_t* lo_row    = NULL;
+  const uint8_t* hi_row    = NULL;
+  uint8_t        lo_shift  = 0u;
+  uint8_t        up_shift  = 0u;
+  if (d < 0) {
+    hi_row   = bitmap;
+    up_shift = (uint8_t) -d;
+  } else {
+    uint8_t sp = (uint8_t) (d >> 3);
+    lo_shift   = (uint8_t) (d & 7);
+    lo_row     = &bitmap[(uint16_t) sp * w];
+    if (lo_shift != 0u && (uint8_t) (sp + 1u) < src_pages) {
+      hi_row   = &bitmap[(uint16_t) (sp + 1u) * w];
+      up_shift = (uint8_t) (8u - lo_shift);
+    }
+  }
+  uint8_t* buf = gfx_get_shared_buffer();
+  uint8_t  sx  = (uint8_t) (x0 - x);
+  for (uint8_t cx = x0; cx <= x1; cx++, sx++) {
+    uint8_t bits = 0u;
+    if (lo_row) {
+      bits = (uint8_t) (lo_row[sx] >> lo_shift);
+    }
+    if (hi_row) {
+      bits |= (uint8_t) (hi_row[sx] << up_shift);
+    }
+    buf[cx] |= (uint8_t) (bits & mask);
+  }
+}
@@ -2,17 +2,116 @@
  * @file gfx_shared.c
  * @brief Implementation of shared 128-byte tile buffer helpers.
  */
+#include "gfx_shared.h"
+
 #include <stdint.h>
 #include <string.h>
 
-static uint8_t gfx_shared_buffer[128];
+static uint8_t gfx_shared_storage[GFX_TILE_BUFFERS][GFX_TILE_HEADROOM + GFX_TILE_WIDTH];
+#if GFX_TILE_BUFFERS > 1
+static uint8_t gfx_shared_index; /* buffer currently handed out */
+#else
+#define gfx_shared_index 0u
+#endif
 
 uint8_t* gfx_get_shared_buffer(void)
 {
-  return gfx_shared_buffer;
+  return &gfx_shared_storage[gfx_shared_index][GFX_TILE_HEADROOM];
 }
 
 void gfx_clear_shared_buffer(void)
 {
-  memset(gfx_shared_buffer, 0, sizeof(gfx_shared_buffer));
+  memset(gfx_get_shared_buffer(), 0, GFX_TILE_WIDTH);
+}
+
+#if GFX_TILE_BUFFERS > 1
+void gfx_swap_shared_buffer(void)
+{
+  gfx_shared_index = (uint8_t) ((gfx_shared_index + 1u) % GFX_TILE_BUFFERS);
+}
+#endif
+
+/**
+ * Blit a 5x8 text run into the shared page buffer.
+ *
+ * The vertical clip (page rows intersected with [clip_top, clip_bottom]) and the glyph
+ * shift are resolved once per run, so every column is a single shift, mask and OR.
+ * Page-aligned, unclipped runs copy glyph bytes directly.
+ */
+void gfx_draw_text_clipped(int16_t     x,
+                           int16_t     pixel_y,
+                           const char* text,
+                           uint8_t     clip_top,
+                           uint8_t     clip_bottom,
+                           uint8_t     page_top)
+{
+  if (!text) {
+    return;
+  }
+  int16_t lo = (clip_top > page_top) ? (int16_t) clip_top : (int16_t) page_top;
+  int16_t hi = (int16_t) (page_top + GFX_PAGE_HEIGHT - 1);
+  if ((int16_t) clip_bottom < hi) {
+    hi = (int16_t) clip_bottom;
+  }
+  if (pixel_y > lo) {
+    lo = pixel_y;
+  }
+  if ((int16_t) (pixel_y + GFX_FONT_CHAR_HEIGHT - 1) < hi) {
+    hi = (int16_t) (pixel_y + GFX_FONT_CHAR_HEIGHT - 1);
+  }
+  if (lo > hi) {
+    return;
+  }
+  /* Row mask within the page and glyph shift (-7..+7) */
+  uint8_t mask  = (uint8_t) ((0xFFu >> (7 - (hi - page_top))) & (0xFFu << (lo - page_top)));
+  int8_t  shift = (int8_t) (pixel_y - (int16_t) page_top);
+
+  uint8_t* buf = gfx_get_shared_buffer();
+  int16_t  cx  = x;
+  while (*text && cx < (int16_t) GFX_TILE_WIDTH) {
+    uint8_t ch = (uint8_t) *text;
+    if (ch < GFX_FONT_FIRST_CHAR || ch > GFX_FONT_LAST_CHAR) {
+      ch = GFX_FONT_FIRST_CHAR;
+    }
+    const uint8_t* glyph = GFX_FONT_DATA[ch - GFX_FONT_FIRST_CHAR];
+    uint8_t        col   = 0u;
+    if (cx < 0) {
+      /* Skip columns left of the panel */
+      int16_t skip = (int16_t) -cx;
+      if (skip >= GFX_FONT_CHAR_SPACING) {
+        cx = (int16_t) (cx + GFX_FONT_CHAR_SPACING);
+        text++;
+        continue;
+      }
+      if (skip > GFX_FONT_CHAR_WIDTH) {
+        skip = GFX_FONT_CHAR_WIDTH;
+      }
+      col = (uint8_t) skip;
+      cx  = (int16_t) (cx + skip);
+    }
+    uint8_t* dst  = &buf[(uint8_t) cx];
+    uint8_t  cols = (uint8_t) (GFX_FONT_CHAR_WIDTH - col);
+    if ((int16_t) (cx + cols) > (int16_t) GFX_TILE_WIDTH) {
+      cols = (uint8_t) (GFX_TILE_WIDTH - cx);
+    }
+    if (shift == 0 && mask == 0xFFu) {
+      for (uint8_t i = 0; i < cols; i++) {
+        dst[i] |= glyph[col + i];
+      }
+    } else if (shift >= 0) {
+      for (uint8_t i = 0; i < cols; i++) {
+        dst[i] |= (uint8_t) ((uint8_t) (glyph[col + i] << shift) & mask);
+      }
+    } else {
+      uint8_t rshift = (uint8_t) -shift;
+      for (uint8_t i = 0; i < cols; i++) {
+        dst[i] |= (uint8_t) ((uint8_t) (glyph[col + i] >> rshift) & mask);
+      }
+    }
+    cx = (int16_t) (cx + cols);
+    if (cx < (int16_t) GFX_TILE_WIDTH) {
+      cx++;
+    }
+    text++;
+  }
 }
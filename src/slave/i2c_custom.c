@@ -44,30 +44,22 @@
 
 // Rely solely on hardware flags/CNTR for DMA status tracking
 
+/* Hook run from the transfer interrupts after STOP */
+static void (*volatile g_tx_done_cb)(i2c_err_t status);
+
+/* Transfer in progress: set by i2c_write_raw_dma(), cleared just before the done hook */
+static volatile uint8_t g_tx_busy;
+/* Address byte the event interrupt sends once START is on the bus */
+static volatile uint8_t g_tx_addr;
+
 // Forward declarations
-static i2c_err_t i2c_wait_flag(uint32_t flag, uint8_t state, uint32_t timeout);
 static i2c_err_t i2c_wait_not_busy(void);
-static i2c_err_t i2c_start(void);
 static i2c_err_t i2c_stop(void);
-static i2c_err_t i2c_send_address(uint8_t addr);
+static void      i2c_tx_finish(i2c_err_t status);
 static void      i2c_dma_init(void);
 /* Single busy poll API; no separate i2c_dma_wait_complete or public idle-wait function */
 
 // Static helper functions implementation
-/** Wait for STAR1 flag to match expected state (timeout_unused is reserved, unused). */
-static i2c_err_t i2c_wait_flag(uint32_t flag, uint8_t state, uint32_t timeout_unused)
-{
-  (void) timeout_unused;
-  while (((I2C1->STAR1 & flag) ? 1U : 0U) != state) {
-    // If NACK occurs during wait, clear and hang for debugging visibility
-    if (I2C1->STAR1 & I2C_STAR1_AF) {
-      I2C1->STAR1 &= ~I2C_STAR1_AF;
-      while (1) {}
-    }
-  }
-  return I2C_OK;
-}
-
 /** Wait until the I2C BUSY flag clears. */
 static i2c_err_t i2c_wait_not_busy(void)
 {
@@ -75,18 +67,6 @@ static i2c_err_t i2c_wait_not_busy(void)
   return I2C_OK;
 }
 
-/** Issue START and wait for SB flag. */
-static i2c_err_t i2c_start(void)
-{
-  i2c_err_t result = i2c_wait_not_busy();
-  if (result != I2C_OK) {
-    return result;
-  }
-
-  I2C1->CTLR1 |= I2C_CTLR1_START;
-  return i2c_wait_flag(I2C_STAR1_SB, 1, I2C_TIMEOUT);
-}
-
 /** Issue STOP condition. */
 static i2c_err_t i2c_stop(void)
 {
@@ -94,30 +74,16 @@ static i2c_err_t i2c_stop(void)
   return I2C_OK;
 }
 
-/** Send 7-bit address in write mode and wait for transmitter state. */
-static i2c_err_t i2c_send_address(uint8_t addr)
+/** End the transfer: quiet the interrupts and the DMA channel, then run the done hook. */
+static void i2c_tx_finish(i2c_err_t status)
 {
-  I2C1->DATAR = addr;
-
-  // Wait for address sent and mode selected (infinite wait for debug)
-  for (;;) {
-    uint32_t sr1 = I2C1->STAR1;
-    uint32_t sr2 = I2C1->STAR2;
-
-    // Check for successful transmitter mode selection
-    if ((sr1 & I2C_STAR1_ADDR) && (sr2 & I2C_STAR2_MSL) && (sr2 & I2C_STAR2_TRA)) {
-      // Address acknowledged and in transmitter mode
-      // IMPORTANT: Clear ADDR by reading SR1 then SR2 (hardware requirement)
-      (void) I2C1->STAR1;
-      (void) I2C1->STAR2;
-      return I2C_OK;
-    }
-
-    // Check for NACK
-    if (sr1 & I2C_STAR1_AF) {
-      I2C1->STAR1 &= ~I2C_STAR1_AF;  // Clear then hang for debug
-      while (1) {}
-    }
+  I2C1->CTLR2 &= ~(I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN);
+  DMA1_Channel6->CFGR &= ~DMA_CFGR_EN;
+  DMA1_Channel6->CNTR = 0;
+  i2c_stop();
+  g_tx_busy = 0;
+  if (g_tx_done_cb) {
+    g_tx_done_cb(status);
   }
 }
 
@@ -140,46 +106,31 @@ static void i2c_dma_init(void)
   *(volatile uint32_t*) (DMA1_BASE + DMA_CFGR6_OFFSET) = 0;
 }
 
-/* Non-blocking busy check (1=busy,0=idle). Pure register read: CNTR>0 or EN bit set. */
+/* Non-blocking busy check (1=busy,0=idle): from i2c_write_raw_dma() until the done hook. */
 int i2c_tx_dma_busy(void)
 {
-  if (DMA1_Channel6->CFGR & DMA_CFGR_EN) {
-    return 1; /* channel enabled */
-  }
-  if (DMA1_Channel6->CNTR != 0) {
-    return 1; /* residual count */
-  }
-  return 0;
+  return g_tx_busy;
 }
 /* Note that buf is not overwritten until dma complete and dma shall not be started before previous
- * dma complete */
+ * dma complete. Only queues START: the event interrupt sends the address and enables the DMA
+ * channel, so this returns within the bus-free time after the previous STOP. */
 i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len)
 {
   if (!dev || !buf || len == 0) {
     return I2C_ERR_BERR;
   }
+  if (g_tx_busy) {
+    return I2C_ERR_BUSY;
+  }
   i2c_err_t result;
 
+  /* The previous STOP is still on the bus for at most one byte time */
   result = i2c_wait_not_busy();
   if (result != I2C_OK) {
     return result;
   }
 
-  // Start I2C transaction
-  result = i2c_start();
-  if (result != I2C_OK) {
-    return result;
-  }
-
-  // Send device address (write)
-  uint8_t write_addr = (dev->addr << 1) & 0xFE;
-  result             = i2c_send_address(write_addr);
-  if (result != I2C_OK) {
-    i2c_stop();
-    return result;
-  }
-
-  // Enable I2C DMA requests and DMA channel
+  // Prepare the DMA channel; the event interrupt enables it once the address is acknowledged
   // Clear hardware flags just before enabling to avoid races
   DMA1->INTFCR = DMA_ISR_TCIF6 | DMA_ISR_HTIF6 | DMA_ISR_TEIF6;
 
@@ -194,8 +145,12 @@ i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const s
                         DMA_CFGR_PL_HIGH | DMA_CFGR_TCIE | DMA_CFGR_TEIE;
 
   DMA1_Channel6->CFGR = dma_config;
-  /* channel becomes busy once enabled */
-  DMA1_Channel6->CFGR |= DMA_CFGR_EN;
+
+  // Start I2C transaction: SB and ADDR are handled in I2C1_EV_IRQHandler
+  g_tx_addr = (uint8_t) ((dev->addr << 1) & 0xFE);
+  g_tx_busy = 1;
+  I2C1->CTLR2 |= I2C_CTLR2_ITEVTEN | I2C_CTLR2_ITERREN;
+  I2C1->CTLR1 |= I2C_CTLR1_START;
 
   return I2C_OK;
 }
@@ -240,6 +195,8 @@ i2c_err_t i2c_init(i2c_device_t* dev)
   I2C1->CTLR1 |= I2C_CTLR1_PE;
 
   I2C1->CTLR2 |= I2C_CTLR2_DMAEN;
+  NVIC_EnableIRQ(I2C1_EV_IRQn);
+  NVIC_EnableIRQ(I2C1_ER_IRQn);
   i2c_dma_init();
 
   // Wait for I2C peripheral to stabilize
@@ -258,13 +215,15 @@ void __attribute__((interrupt)) DMA1_Channel6_IRQHandler(void)
     DMA1->INTFCR = DMA_ISR_TCIF6;
     stop         = 1;
   }
-  if (dma_isr & DMA_ISR_TEIF6) {
-    DMA1->INTFCR = DMA_ISR_TEIF6;
-    stop         = 1;
-  }
   if (dma_isr & DMA_ISR_HTIF6) {
     DMA1->INTFCR = DMA_ISR_HTIF6;
   }
+  if (dma_isr & DMA_ISR_TEIF6) {
+    /* Abort: the bytes may never shift out, so do not wait for TXE */
+    DMA1->INTFCR = DMA_ISR_TEIF6;
+    i2c_tx_finish(I2C_ERR_BERR);
+    return;
+  }
   if (stop) {
     /* Disable DMA requests first */
     DMA1_Channel6->CFGR &= ~DMA_CFGR_EN;
@@ -276,7 +235,41 @@ void __attribute__((interrupt)) DMA1_Channel6_IRQHandler(void)
     while (DMA1_Channel6->CNTR != 0) {
       /* wait */
     }
-    i2c_stop();
     /* idle state observed by busy() */
+    i2c_tx_finish(I2C_OK);
   }
 }
+
+/* I2C1 event interrupt: START and address phase of i2c_write_raw_dma() */
+void __attribute__((interrupt)) I2C1_EV_IRQHandler(void)
+{
+  uint32_t sr1 = I2C1->STAR1;
+  if (sr1 & I2C_STAR1_SB) {
+    /* Reading STAR1 then writing DATAR clears SB */
+    I2C1->DATAR = g_tx_addr;
+    return;
+  }
+  if (sr1 & I2C_STAR1_ADDR) {
+    /* Reading STAR1 then STAR2 clears ADDR; the DMA channel feeds the rest and its
+       interrupt ends the transfer, so byte events are no longer needed */
+    (void) I2C1->STAR2;
+    I2C1->CTLR2 &= ~I2C_CTLR2_ITEVTEN;
+    DMA1_Channel6->CFGR |= DMA_CFGR_EN;
+  }
+}
+
+/* I2C1 error interrupt: address or data not acknowledged, bus error, lost arbitration */
+void __attribute__((interrupt)) I2C1_ER_IRQHandler(void)
+{
+  uint32_t  sr1    = I2C1->STAR1;
+  i2c_err_t status = (sr1 & I2C_STAR1_AF) ? I2C_ERR_NACK : I2C_ERR_BERR;
+  I2C1->STAR1 &= ~(I2C_STAR1_AF | I2C_STAR1_BERR | I2C_STAR1_ARLO);
+  if (g_tx_busy) {
+    i2c_tx_finish(status);
+  }
+}
+
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status))
+{
+  g_tx_done_cb = callback;
+}
@@ -28,8 +28,11 @@
 #include "ssd1306_driver.h"
 #include "gfx_font.h"
 #include "gfx_shared.h"
+#include "ui_focus.h"
+#include "ui_persist.h"
 #include "ui_protocol.h"
 #include "spi_slave_dma.h"
+#include "status_codes.h"
 #include "debug_led.h"
 /* GLOBALS */
 
@@ -288,7 +291,7 @@ static void enter_standby_wait_cs_falling(void)
     ssd1306_clear();
   }
   //local_buttons_setup();
-  g_render_requested = 1;
+  protocol_request_render();
 }
 
 /**
@@ -299,7 +302,7 @@ static void enter_standby_wait_cs_falling(void)
  * 2. LCD power supply setup
  * 3. SSD1306 display driver initialization
  * 4. UI protocol stack initialization
- * 5. Boot screen display
+ * 5. Saved UI restore from flash, or the boot screen
  */
 void system_init(void)
 {
@@ -313,9 +316,13 @@ void system_init(void)
   /* Initialize SPI slave transport early so we're ready before any host traffic */
   protocol_init();
   ssd1306_init();
+  ssd1306_render_async_set_frame_callback(render_frame_begin);
   ssd1306_set_height(64);
   ssd1306_clear();
-  show_boot_banner();
+  /* A UI saved with SAVE_UI comes back without the host; the main loop renders it */
+  if (ui_persist_restore() != RES_OK) {
+    show_boot_banner();
+  }
   /* Startup prints are disabled to reduce logs */
   spi_slave_transport_init();
   debug_led_write(1U);
@@ -342,6 +349,7 @@ static void normalize_active_screen(void)
 {
   if (g_protocol_state.active_screen >= g_protocol_state.screen_count) {
     g_protocol_state.active_screen = 0u;
+    protocol_invalidate_visibility();
   }
 }
 
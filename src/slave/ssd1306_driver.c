@@ -17,6 +17,31 @@
 #include "gfx_shared.h"
 #include "status_codes.h"
 
+/* Column segments per page that keep a checksum of the last streamed bytes (0 disables).
+ * Must divide SSD1306_WIDTH; each segment costs 2 bytes of RAM per page. */
+#ifndef SSD1306_PAGE_HASH_SEGMENTS
+#define SSD1306_PAGE_HASH_SEGMENTS 2u
+#endif
+
+/* GDDRAM is 64 rows (8 pages) regardless of the configured panel height. */
+#define SSD1306_RAM_PAGES 8u
+#define SSD1306_RAM_ROWS 64u
+
+/* Control byte prefixes: Co=1 carries exactly one command byte; 0x40 starts a data run */
+#define SSD1306_CTRL_CMD_SINGLE 0x80u
+#define SSD1306_CTRL_DATA 0x40u
+/* Six command bytes, each with its control byte, then the data control byte */
+#define SSD1306_STREAM_HEADER_LEN 13
+#if SSD1306_STREAM_SINGLE_XFER && (GFX_TILE_HEADROOM < SSD1306_STREAM_HEADER_LEN)
+#error "GFX_TILE_HEADROOM must hold the SSD1306 page stream header"
+#endif
+
+/* The transfer interrupt launches a page built ahead in the other tile buffer. Chunked
+ * streaming sends the address window with a blocking write, so it launches pages from
+ * the main loop. */
+#define SSD1306_IRQ_PAGE_LAUNCH \
+  (SSD1306_XFER_IRQ_CHAIN && SSD1306_STREAM_SINGLE_XFER && GFX_TILE_BUFFERS > 1)
+
 /* Max raw data payload bytes per I2C DMA burst (excludes 1 control byte). */
 #define I2C_BUFFER_LIMIT 28
 /* Ping-pong buffers: each holds a control byte + payload. We double-buffer to build
@@ -32,10 +57,16 @@ static i2c_device_t g_i2c_dev = {.clkr = 400000,
                                  .tout = 2000};
 static uint8_t       g_height  = SSD1306_HEIGHT; /**< Current display height (32 or 64). */
 static uint8_t       g_pages   = SSD1306_PAGES;  /**< Current number of pages (4 or 8). */
+static uint8_t       g_start_line;       /**< Start line the next frame is rendered for (0..63). */
+static uint8_t       g_panel_start_line; /**< Start line last sent to the panel. */
 
 /* Forward declarations for helpers used before their definitions */
-static void ssd1306_set_addr(uint8_t page_start, uint8_t page_end);
+static void ssd1306_set_addr(uint8_t page_start,
+                             uint8_t page_end,
+                             uint8_t col_start,
+                             uint8_t col_end);
 static int  ssd1306_commands(const uint8_t* cmds, int cmds_len);
+static void ssd1306_hash_reset(void);
 
 /*
  * Burst command helper: send N command bytes in one I2C transaction:
@@ -44,17 +75,50 @@ static int  ssd1306_commands(const uint8_t* cmds, int cmds_len);
  */
 /* ================= Non-blocking low level streaming transfer ================= */
 typedef struct {
-  uint8_t        active;    /**< 1 while a multi-chunk transfer is active */
+  volatile uint8_t active;  /**< 1 while a multi-chunk transfer is active */
   uint8_t        control;   /**< Control byte (0x00 commands / 0x40 data) */
   const uint8_t* bytes;     /**< Source pointer */
   int            total_len; /**< Total length remaining to send */
-  int            sent;      /**< Bytes already queued (not counting in-flight) */
+  volatile int   sent;      /**< Bytes handed to the DMA, including the chunk in flight */
 } ssd1306_dma_xfer_state_t;
 
 static ssd1306_dma_xfer_state_t g_xfer;
 
-/** Kick off a non-blocking I2C transfer using the DMA backend. */
-static void ssd1306_dma_xfer_start(uint8_t control, const uint8_t* bytes, int len)
+/**
+ * Launch the next chunk, or mark the transfer finished when everything was issued.
+ * The DMA must be idle: called from the main loop after i2c_tx_dma_busy() reads 0, or
+ * from the completion interrupt with SSD1306_XFER_IRQ_CHAIN.
+ */
+static int ssd1306_dma_xfer_next(void)
+{
+  if (g_xfer.sent >= g_xfer.total_len) {
+    /* All data issued */
+    g_xfer.active = 0U;
+    return 0;
+  }
+  int     remaining = g_xfer.total_len - g_xfer.sent;
+  int     chunk     = remaining > I2C_BUFFER_LIMIT ? I2C_BUFFER_LIMIT : remaining;
+  uint8_t bi        = bulk_index ^ 1u; /* pick opposite buffer */
+  /* Build next chunk */
+  bulk_buffer[bi][0] = g_xfer.control;
+  memcpy(&bulk_buffer[bi][1], &g_xfer.bytes[g_xfer.sent], (size_t) chunk);
+  /* Count the chunk before launching it: its completion interrupt may fire before
+     i2c_write_raw_dma() returns and must see the last chunk as issued */
+  bulk_index = bi;
+  g_xfer.sent += chunk;
+  /* Launch DMA (assumes g_i2c_dev is valid after ssd1306_init) */
+  int r = i2c_write_raw_dma(&g_i2c_dev, bulk_buffer[bi], (size_t) chunk + 1U);
+  if (r != 0) {
+    /* Abort on error; the panel no longer matches stored checksums */
+    g_xfer.active = 0U;
+    ssd1306_hash_reset();
+    return 1;
+  }
+  return 0;
+}
+
+/** Kick off a non-blocking I2C transfer using the DMA backend; non-zero if it failed to start. */
+static int ssd1306_dma_xfer_start(uint8_t control, const uint8_t* bytes, int len)
 {
   /* If display frame async is active, we do NOT block: higher layer should avoid starting
      conflicting transfers. (Old code blocked here; now we rely on sequencing in caller.) */
@@ -63,10 +127,37 @@ static void ssd1306_dma_xfer_start(uint8_t control, const uint8_t* bytes, int le
   g_xfer.bytes     = bytes;
   g_xfer.total_len = len;
   g_xfer.sent      = 0;
+#if SSD1306_XFER_IRQ_CHAIN
+  /* The first chunk goes out now; the interrupt chains the rest */
+  if (!i2c_tx_dma_busy()) {
+    return ssd1306_dma_xfer_next();
+  }
+#endif
+  return 0;
 }
 
+#if SSD1306_STREAM_SINGLE_XFER
+/** Launch one prebuilt transaction (control bytes included); returns non-zero on error. */
+static int ssd1306_dma_xfer_start_raw(const uint8_t* frame, int len)
+{
+  g_xfer.active    = 1U;
+  g_xfer.control   = 0U;
+  g_xfer.bytes     = frame;
+  g_xfer.total_len = len;
+  g_xfer.sent      = len; /* nothing left to chunk; completes once the DMA drains */
+  if (i2c_write_raw_dma(&g_i2c_dev, frame, (size_t) len) != 0) {
+    /* The panel no longer matches stored checksums */
+    g_xfer.active = 0U;
+    ssd1306_hash_reset();
+    return 1;
+  }
+  return 0;
+}
+#endif
+
 /** \brief Progress the non-blocking transfer state machine.
- *  Call from main loop (and before starting new frame segments). */
+ *  Call from main loop (and before starting new frame segments): launches the next
+ *  chunk once the previous one has drained. */
 static void ssd1306_dma_xfer_process(void)
 {
   if (!g_xfer.active) {
@@ -76,26 +167,7 @@ static void ssd1306_dma_xfer_process(void)
   if (i2c_tx_dma_busy()) {
     return;
   }
-  if (g_xfer.sent >= g_xfer.total_len) {
-    /* All data issued */
-    g_xfer.active = 0U;
-    return;
-  }
-  int     remaining = g_xfer.total_len - g_xfer.sent;
-  int     chunk     = remaining > I2C_BUFFER_LIMIT ? I2C_BUFFER_LIMIT : remaining;
-  uint8_t bi        = bulk_index ^ 1u; /* pick opposite buffer */
-  /* Build next chunk */
-  bulk_buffer[bi][0] = g_xfer.control;
-  memcpy(&bulk_buffer[bi][1], &g_xfer.bytes[g_xfer.sent], (size_t) chunk);
-  /* Launch DMA (assumes g_i2c_dev is valid after ssd1306_init) */
-  int r = i2c_write_raw_dma(&g_i2c_dev, bulk_buffer[bi], (size_t) chunk + 1U);
-  if (r != 0) {
-    /* Abort on error */
-    g_xfer.active = 0U;
-    return;
-  }
-  bulk_index = bi;
-  g_xfer.sent += chunk;
+  (void) ssd1306_dma_xfer_next();
 }
 
 /** \brief Blocking helper built atop non-blocking streaming state.
@@ -113,7 +185,7 @@ static int ssd1306_dma_xfer_block(uint8_t control, const uint8_t* bytes, int len
   while (g_xfer.active) {
     ssd1306_dma_xfer_process();
   }
-  ssd1306_dma_xfer_start(control, bytes, len);
+  (void) ssd1306_dma_xfer_start(control, bytes, len);
   while (g_xfer.active) {
     ssd1306_dma_xfer_process();
   }
@@ -123,19 +195,170 @@ static int ssd1306_dma_xfer_block(uint8_t control, const uint8_t* bytes, int len
 /* ================= Asynchronous frame render (main-loop driven) ================ */
 typedef struct {
   uint8_t active;             /* 1 while an async full-frame render in progress */
-  uint8_t page;               /* current page (tile index) being sent */
-  uint8_t stage;              /* multi-stage state (see enum) */
+  volatile uint8_t page;      /* current page (tile index); advanced by the transfer interrupt */
+  volatile uint8_t stage;     /* multi-stage state (see enum) */
   void (*cb)(uint8_t tile_y); /* user render callback */
+  void (*frame_cb)(void);     /* optional hook run once before page 0 of each frame */
   uint8_t rerender_pending;   /* request to rerun another frame after finish */
+  uint8_t page_mask;          /* damaged pages latched for the current frame (bit per page) */
+  uint8_t col_first;          /* first damaged column latched for the current frame */
+  uint8_t col_last;           /* last damaged column latched for the current frame */
+  uint8_t seg_first;          /* first column streamed for the current page */
+  uint8_t seg_last;           /* last column streamed for the current page */
+  uint8_t start_line;         /* display start line latched for the current frame */
+#if SSD1306_PERF_STATS
+  uint8_t stream_timed;       /* current page was sent (not skipped by its checksum) */
+#endif
+#if GFX_TILE_BUFFERS > 1
+  volatile uint8_t in_flight; /* a page transfer still reads the other tile buffer */
+#endif
 } ssd1306_async_state_t;
 
 static ssd1306_async_state_t g_async;
 
+#if SSD1306_PERF_STATS
+/* window_ms holds the SysTick value at the start of the window until it is read */
+static ssd1306_perf_t g_perf = {.build_min_us = 0xFFFFu, .stream_min_us = 0xFFFFu};
+static uint32_t       g_perf_mark; /* SysTick value when the page transfer began */
+
+/** Microseconds since a SysTick mark, saturated to 16 bits. */
+static uint16_t ssd1306_perf_elapsed_us(uint32_t mark)
+{
+  uint32_t us = (uint32_t) (SysTick->CNT - mark) / DELAY_US_TIME;
+  return (us > 0xFFFFu) ? 0xFFFFu : (uint16_t) us;
+}
+
+/** Fold one sample into a min/max/sum triple. */
+static void ssd1306_perf_add(uint16_t us, uint16_t* min_us, uint16_t* max_us, uint32_t* sum_us)
+{
+  if (us < *min_us) {
+    *min_us = us;
+  }
+  if (us > *max_us) {
+    *max_us = us;
+  }
+  *sum_us += us;
+}
+
+int ssd1306_perf_read(ssd1306_perf_t* out)
+{
+  if (!out) {
+    return RES_INTERNAL;
+  }
+  uint32_t now = SysTick->CNT;
+#if SSD1306_XFER_IRQ_CHAIN
+  /* Page transfers are recorded from the DMA interrupt */
+  __disable_irq();
+#endif
+  *out           = g_perf;
+  out->window_ms = (uint32_t) (now - g_perf.window_ms) / DELAY_MS_TIME;
+  if (out->builds == 0u) {
+    out->build_min_us = 0u;
+  }
+  if (out->streams == 0u) {
+    out->stream_min_us = 0u;
+  }
+  memset(&g_perf, 0, sizeof(g_perf));
+  g_perf.build_min_us  = 0xFFFFu;
+  g_perf.stream_min_us = 0xFFFFu;
+  g_perf.window_ms     = now;
+#if SSD1306_XFER_IRQ_CHAIN
+  __enable_irq();
+#endif
+  return RES_OK;
+}
+#else
+int ssd1306_perf_read(ssd1306_perf_t* out)
+{
+  (void) out;
+  return RES_BAD_STATE;
+}
+#endif
+
+/** Damage accumulated since the last frame start (empty mask = nothing recorded). */
+typedef struct {
+  uint8_t page_mask; /* bit per page */
+  uint8_t col_first; /* union column window across damaged pages */
+  uint8_t col_last;
+} ssd1306_damage_t;
+
+static ssd1306_damage_t g_damage;
+
+#if SSD1306_PAGE_HASH_SEGMENTS > 0
+#define SSD1306_HASH_SEG_COLS (SSD1306_WIDTH / SSD1306_PAGE_HASH_SEGMENTS)
+/* Checksum of the bytes last streamed to each page segment; valid only when the page bit is set. */
+static uint16_t g_page_hash[8][SSD1306_PAGE_HASH_SEGMENTS];
+static uint8_t  g_page_hash_valid;
+
+/** Forget stored checksums so the next frame streams every damaged segment. */
+static void ssd1306_hash_reset(void)
+{
+  g_page_hash_valid = 0u;
+}
+
+/**
+ * CRC-16/CCITT (poly 0x1021) of one segment, byte-wise without a table. A CRC catches
+ * every change that fits in 16 consecutive bits, so a column flipping between 0x00 and
+ * 0xFF (a Fletcher mod-255 blind spot) or a bit moving to a nearby column always shows.
+ */
+static uint16_t ssd1306_hash_segment(const uint8_t* bytes)
+{
+  uint16_t crc = 0xFFFFu;
+  for (uint8_t i = 0; i < SSD1306_HASH_SEG_COLS; i++) {
+    uint8_t x = (uint8_t) ((crc >> 8) ^ bytes[i]);
+    x         = (uint8_t) (x ^ (x >> 4));
+    crc       = (uint16_t) ((crc << 8) ^ ((uint16_t) x << 12) ^ ((uint16_t) x << 5) ^ x);
+  }
+  return crc;
+}
+
+/**
+ * Shrink [*col_first, *col_last] to the changed segments of the built page and record
+ * their new checksums. Changed segments are streamed whole so the stored checksum always
+ * matches the panel. Returns 0 when nothing in the window changed.
+ */
+static uint8_t ssd1306_hash_narrow(uint8_t page, uint8_t* col_first, uint8_t* col_last)
+{
+  const uint8_t* shared_buf = gfx_get_shared_buffer();
+  uint8_t        valid      = (uint8_t) (g_page_hash_valid & (1u << page));
+  uint8_t        seg_first  = (uint8_t) (*col_first / SSD1306_HASH_SEG_COLS);
+  uint8_t        seg_last   = (uint8_t) (*col_last / SSD1306_HASH_SEG_COLS);
+  uint8_t        changed_lo = 0xFFu;
+  uint8_t        changed_hi = 0u;
+  for (uint8_t seg = seg_first; seg <= seg_last; seg++) {
+    uint16_t h = ssd1306_hash_segment(&shared_buf[seg * SSD1306_HASH_SEG_COLS]);
+    if (valid != 0u && g_page_hash[page][seg] == h) {
+      continue;
+    }
+    g_page_hash[page][seg] = h;
+    if (changed_lo == 0xFFu) {
+      changed_lo = seg;
+    }
+    changed_hi = seg;
+  }
+  if (changed_lo == 0xFFu) {
+    return 0u;
+  }
+  if (valid == 0u) {
+    /* Segments outside the window were never hashed; keep them unknown by
+       validating the page only when the window covers it fully. */
+    if (seg_first == 0u && seg_last == (uint8_t) (SSD1306_PAGE_HASH_SEGMENTS - 1u)) {
+      g_page_hash_valid |= (uint8_t) (1u << page);
+    }
+  }
+  *col_first = (uint8_t) (changed_lo * SSD1306_HASH_SEG_COLS);
+  *col_last  = (uint8_t) ((changed_hi + 1u) * SSD1306_HASH_SEG_COLS - 1u);
+  return 1u;
+}
+#else
+static void ssd1306_hash_reset(void) {}
+#endif
+
 /* Async render stages */
 enum {
-  SSD1306_ASYNC_STAGE_ADDR         = 0, /* Need to set column/page address */
-  SSD1306_ASYNC_STAGE_BUILD        = 1, /* Build shared buffer page via callback */
-  SSD1306_ASYNC_STAGE_STREAM_START = 2, /* Start non-blocking transfer of page bytes */
+  SSD1306_ASYNC_STAGE_ADDR         = 0, /* Compare checksums, narrow the column window */
+  SSD1306_ASYNC_STAGE_BUILD        = 1, /* Build shared buffer page via callback (first per page) */
+  SSD1306_ASYNC_STAGE_STREAM_START = 2, /* Send the address window and start the page transfer */
   SSD1306_ASYNC_STAGE_STREAMING    = 3, /* Streaming in progress (chunks) */
 };
 
@@ -148,23 +371,152 @@ int ssd1306_render_async_busy(void)
 void ssd1306_render_async_request_rerender(void)
 {
   if (g_async.active) {
+#if SSD1306_PERF_STATS
+    if (g_async.rerender_pending) {
+      g_perf.coalesced++;
+    }
+#endif
     g_async.rerender_pending = 1;
   }
 }
 
+/** Register a hook invoked once at the start of every frame (NULL to disable). */
+void ssd1306_render_async_set_frame_callback(void (*frame_callback)(void))
+{
+  g_async.frame_cb = frame_callback;
+}
+
+/** Merge a page/column rectangle into the pending damage. */
+void ssd1306_invalidate_region(uint8_t page_first,
+                               uint8_t page_last,
+                               uint8_t col_first,
+                               uint8_t col_last)
+{
+  if (page_first > page_last || col_first > col_last || page_first >= 8u) {
+    return;
+  }
+  if (page_last > 7u) {
+    page_last = 7u;
+  }
+  if (col_last >= SSD1306_WIDTH) {
+    col_last = (uint8_t) (SSD1306_WIDTH - 1);
+  }
+  uint8_t mask = (uint8_t) ((0xFFu >> (7u - page_last)) & (0xFFu << page_first));
+  if (g_damage.page_mask == 0u) {
+    g_damage.col_first = col_first;
+    g_damage.col_last  = col_last;
+  } else {
+    if (col_first < g_damage.col_first) {
+      g_damage.col_first = col_first;
+    }
+    if (col_last > g_damage.col_last) {
+      g_damage.col_last = col_last;
+    }
+  }
+  g_damage.page_mask |= mask;
+}
+
+/** Mark every page and column as damaged. */
+void ssd1306_invalidate_all(void)
+{
+  g_damage.col_first = 0u;
+  g_damage.col_last  = (uint8_t) (SSD1306_WIDTH - 1);
+  g_damage.page_mask = 0xFFu;
+}
+
+/**
+ * Map panel pages to the GDDRAM pages that hold them under start_line.
+ * A start line that is not page aligned spreads each panel page over two GDDRAM pages.
+ */
+static uint8_t ssd1306_ram_page_mask(uint8_t panel_mask, uint8_t start_line)
+{
+  panel_mask    = (uint8_t) (panel_mask & ((1u << g_pages) - 1u));
+  uint8_t rot   = (uint8_t) (start_line >> 3);
+  uint8_t mask  = (uint8_t) ((panel_mask << rot) | (panel_mask >> ((8u - rot) & 7u)));
+  if ((start_line & 7u) != 0u) {
+    mask |= (uint8_t) ((mask << 1) | (mask >> 7));
+  }
+  return mask;
+}
+
+/** Move the panel image up by dy rows (down when negative) and damage the exposed rows. */
+void ssd1306_scroll_lines(int8_t dy)
+{
+  if (dy == 0) {
+    return;
+  }
+  if (g_damage.page_mask != 0u) {
+    /* Pending damage was recorded for the old row positions */
+    ssd1306_invalidate_all();
+  }
+  g_start_line  = (uint8_t) ((g_start_line + dy) & (SSD1306_RAM_ROWS - 1u));
+  int16_t first = 0;
+  int16_t last  = (int16_t) (-dy - 1);
+  if (dy > 0) {
+    first = (int16_t) (g_height - dy);
+    last  = (int16_t) (g_height - 1);
+  }
+  if (first < 0) {
+    first = 0;
+  }
+  if (last >= (int16_t) g_height) {
+    last = (int16_t) (g_height - 1);
+  }
+  ssd1306_invalidate_region((uint8_t) (first / SSD1306_PAGE_HEIGHT),
+                            (uint8_t) (last / SSD1306_PAGE_HEIGHT),
+                            0u,
+                            (uint8_t) (SSD1306_WIDTH - 1));
+}
+
+/** Return the start line the current frame is rendered for. */
+uint8_t ssd1306_frame_start_line(void)
+{
+  return g_async.start_line;
+}
+
+/** Return the panel to start line 0; raw page writes address panel pages directly. */
+static void ssd1306_start_line_reset(void)
+{
+  g_start_line       = 0u;
+  g_async.start_line = 0u;
+  if (g_panel_start_line != 0u) {
+    g_panel_start_line = 0u;
+    (void) ssd1306_command(SSD1306_CMD_SET_START_LINE_0);
+  }
+}
+
+/** Run the frame-start hook, then rewind the page state machine and latch the damage. */
+static void ssd1306_async_frame_start(void)
+{
+  g_async.active = 1;
+  g_async.page   = 0;
+  g_async.stage  = SSD1306_ASYNC_STAGE_BUILD;
+  /* The hook runs first so damage and start-line steps it records belong to this frame */
+  if (g_async.frame_cb) {
+    g_async.frame_cb();
+  }
+  /* Latch pending damage; a frame with nothing recorded redraws the whole panel. */
+  if (g_damage.page_mask == 0u) {
+    ssd1306_invalidate_all();
+  }
+  g_async.start_line = g_start_line;
+  g_async.page_mask  = ssd1306_ram_page_mask(g_damage.page_mask, g_start_line);
+  g_async.col_first  = g_damage.col_first;
+  g_async.col_last   = g_damage.col_last;
+  g_damage.page_mask = 0u;
+  debug_log_event(DEBUG_LED_EVT_RENDER_START,
+                  (uint8_t) ((g_pages > 0U) ? (g_pages - 1U) : 0U));
+}
+
 /** Begin async rendering; returns error if already active. */
 int ssd1306_render_async_begin(void (*render_callback)(uint8_t tile_y))
 {
   if (g_async.active) {
     return RES_BAD_STATE; /* already active */
   }
-  g_async.active           = 1;
-  g_async.page             = 0;
-  g_async.stage            = SSD1306_ASYNC_STAGE_ADDR;
   g_async.cb               = render_callback;
   g_async.rerender_pending = 0;
-  debug_log_event(DEBUG_LED_EVT_RENDER_START,
-                  (uint8_t) ((g_pages > 0U) ? (g_pages - 1U) : 0U));
+  ssd1306_async_frame_start();
   return RES_OK;
 }
 
@@ -182,16 +534,172 @@ int ssd1306_render_async_start_or_request(void (*render_callback)(uint8_t tile_y
   return 1;
 }
 
-/** Helper to start page streaming (page is reserved for future use). */
-static void ssd1306_async_start_page_stream(uint8_t page)
+/** Mark the page transfer about to launch as in flight. */
+static void ssd1306_async_enter_streaming(void)
+{
+  g_async.stage = SSD1306_ASYNC_STAGE_STREAMING;
+#if GFX_TILE_BUFFERS > 1
+  g_async.in_flight = 1;
+#endif
+}
+
+#if SSD1306_STREAM_SINGLE_XFER
+/**
+ * Send the address window and the page bytes of [col_first, col_last] as one transaction.
+ * The header is written in place just before col_first: the headroom covers column 0, and
+ * columns left of the window were already checksummed and are rebuilt before reuse.
+ */
+static int ssd1306_async_start_page_stream(uint8_t page, uint8_t col_first, uint8_t col_last)
+{
+  uint8_t*      hdr     = &gfx_get_shared_buffer()[(int) col_first - SSD1306_STREAM_HEADER_LEN];
+  const uint8_t cmds[6] = {
+      SSD1306_CMD_SET_COL_ADDR, col_first, col_last, SSD1306_CMD_SET_PAGE_ADDR, page, page};
+  for (uint8_t i = 0; i < 6u; i++) {
+    hdr[2u * i]      = SSD1306_CTRL_CMD_SINGLE;
+    hdr[2u * i + 1u] = cmds[i];
+  }
+  hdr[SSD1306_STREAM_HEADER_LEN - 1] = SSD1306_CTRL_DATA;
+  /* Enter STREAMING first: the completion interrupt may fire before the call returns */
+  ssd1306_async_enter_streaming();
+  return ssd1306_dma_xfer_start_raw(hdr,
+                                    SSD1306_STREAM_HEADER_LEN + (int) (col_last - col_first) + 1);
+}
+#else
+/** Helper to start page streaming of the column window chosen in the ADDR stage. */
+static int ssd1306_async_start_page_stream(uint8_t page, uint8_t col_first, uint8_t col_last)
 {
   uint8_t* shared_buf = gfx_get_shared_buffer();
-  /* Kick non-blocking streaming of 128 bytes */
-  ssd1306_dma_xfer_start(0x40, shared_buf, SSD1306_WIDTH);
-  (void) page; /* page not needed here but kept for potential future logic */
+  ssd1306_set_addr(page, page, col_first, col_last);
+  /* Enter STREAMING first: the completion interrupt may fire before the call returns */
+  ssd1306_async_enter_streaming();
+  /* Kick non-blocking streaming of the damaged column window */
+  return ssd1306_dma_xfer_start(
+      SSD1306_CTRL_DATA, &shared_buf[col_first], (int) (col_last - col_first) + 1);
 }
+#endif
 
-/** Advance async rendering state machine from the main loop. */
+/** Move on to building the next page. */
+static void ssd1306_async_next_page(void)
+{
+  g_async.page  = (uint8_t) (g_async.page + 1u);
+  g_async.stage = SSD1306_ASYNC_STAGE_BUILD;
+}
+
+/**
+ * A page transfer drained (or failed to start): record its time, then release its tile
+ * buffer (double buffering) or move on to the next page.
+ */
+static void ssd1306_async_stream_done(void)
+{
+#if SSD1306_PERF_STATS
+  if (g_async.stream_timed) {
+    g_async.stream_timed = 0;
+    ssd1306_perf_add(ssd1306_perf_elapsed_us(g_perf_mark),
+                     &g_perf.stream_min_us,
+                     &g_perf.stream_max_us,
+                     &g_perf.stream_sum_us);
+  }
+#endif
+#if GFX_TILE_BUFFERS > 1
+  g_async.in_flight = 0;
+#else
+  ssd1306_async_next_page();
+#endif
+}
+
+/**
+ * Start the transfer of the page compared in the ADDR stage. With two tile buffers, move
+ * on to building the next page in the other buffer while this one streams.
+ */
+static void ssd1306_async_launch_page(void)
+{
+#if SSD1306_PERF_STATS
+  g_perf_mark          = SysTick->CNT;
+  g_async.stream_timed = 1;
+  g_perf.streams++;
+#endif
+  if (ssd1306_async_start_page_stream(g_async.page, g_async.seg_first, g_async.seg_last) != 0) {
+    /* Nothing was sent and no completion will follow */
+    ssd1306_async_stream_done();
+  }
+#if GFX_TILE_BUFFERS > 1
+  gfx_swap_shared_buffer();
+  ssd1306_async_next_page();
+#endif
+}
+
+#if SSD1306_XFER_IRQ_CHAIN
+/** 1 while a page transfer started by the state machine has not drained yet. */
+static uint8_t ssd1306_async_streaming(void)
+{
+#if GFX_TILE_BUFFERS > 1
+  return g_async.in_flight;
+#else
+  return (uint8_t) (g_async.active && g_async.stage == SSD1306_ASYNC_STAGE_STREAMING);
+#endif
+}
+
+#endif
+
+/**
+ * Transfer hook (I2C or DMA interrupt, after STOP). An error aborts the transfer.
+ * With SSD1306_XFER_IRQ_CHAIN the hook launches the next chunk, finishes the page and,
+ * with SSD1306_IRQ_PAGE_LAUNCH, starts the page already built in the other tile buffer,
+ * so the bus keeps moving while the main loop is busy elsewhere.
+ */
+static void ssd1306_dma_xfer_irq(i2c_err_t status)
+{
+  if (!g_xfer.active) {
+    return;
+  }
+  if (status != I2C_OK) {
+    /* The panel no longer matches stored checksums */
+    g_xfer.active = 0U;
+    ssd1306_hash_reset();
+  }
+#if SSD1306_XFER_IRQ_CHAIN
+  else if (g_xfer.sent < g_xfer.total_len) {
+    /* A chunk that fails to launch ends the page below */
+    if (ssd1306_dma_xfer_next() == 0) {
+      return;
+    }
+  } else {
+    g_xfer.active = 0U;
+  }
+  if (ssd1306_async_streaming()) {
+    ssd1306_async_stream_done();
+#if SSD1306_IRQ_PAGE_LAUNCH
+    /* STREAMING is entered before a launch, so this never restarts the page just sent */
+    if (g_async.active && g_async.stage == SSD1306_ASYNC_STAGE_STREAM_START) {
+      ssd1306_async_launch_page();
+    }
+#endif
+  }
+#endif
+}
+
+/** Finish the current frame and restart once if a rerender was requested. */
+static void ssd1306_async_frame_done(void)
+{
+  debug_log_event(DEBUG_LED_EVT_RENDER_DONE, g_async.rerender_pending ? 1u : 0u);
+  /* Move the start line only after the exposed rows were written */
+  if (g_panel_start_line != g_async.start_line) {
+    g_panel_start_line = g_async.start_line;
+    (void) ssd1306_command((uint8_t) (SSD1306_CMD_SET_START_LINE_0 | g_panel_start_line));
+  }
+  g_async.active = 0;
+#if SSD1306_PERF_STATS
+  g_perf.frames++;
+#endif
+  if (g_async.rerender_pending) {
+    g_async.rerender_pending = 0;
+    ssd1306_async_frame_start();
+  }
+}
+
+/** Advance async rendering state machine from the main loop (page builds and recovery;
+ *  with SSD1306_XFER_IRQ_CHAIN the transfer interrupt chains chunks, finishes pages and
+ *  launches pages built ahead). */
 void ssd1306_render_async_process(void)
 {
   if (!g_async.active) {
@@ -200,59 +708,110 @@ void ssd1306_render_async_process(void)
 
   /* Always progress low-level transfer first (if any) */
   ssd1306_dma_xfer_process();
-
-  switch (g_async.stage) {
-    case SSD1306_ASYNC_STAGE_ADDR:
-      if (i2c_tx_dma_busy()) {
-        return; /* wait if something else sending */
-      }
-      debug_log_event(DEBUG_LED_EVT_RENDER_STAGE, (uint8_t) (g_async.page & 0x07u));
-    ssd1306_set_addr(g_async.page, g_async.page);
-      g_async.stage = SSD1306_ASYNC_STAGE_BUILD;
-      break;
-    case SSD1306_ASYNC_STAGE_BUILD:
-      if (i2c_tx_dma_busy()) {
-        return; /* defensive */
-      }
-      gfx_clear_shared_buffer();
-      if (g_async.cb) {
-        g_async.cb(g_async.page);
-      }
-      g_async.stage = SSD1306_ASYNC_STAGE_STREAM_START;
-      break;
-    case SSD1306_ASYNC_STAGE_STREAM_START:
-      if (i2c_tx_dma_busy()) {
-        return; /* ensure bus free */
-      }
-      ssd1306_async_start_page_stream(g_async.page);
-      g_async.stage = SSD1306_ASYNC_STAGE_STREAMING;
-      break;
-    case SSD1306_ASYNC_STAGE_STREAMING:
-      if (g_xfer.active) {
-        /* Still streaming chunks */
-        return;
+#if GFX_TILE_BUFFERS > 1 && !SSD1306_XFER_IRQ_CHAIN
+  if (g_async.in_flight && !g_xfer.active) {
+    ssd1306_async_stream_done();
+  }
+#endif
+
+  for (;;) {
+    switch (g_async.stage) {
+      case SSD1306_ASYNC_STAGE_BUILD: {
+#if GFX_TILE_BUFFERS == 1
+        if (i2c_tx_dma_busy()) {
+          return; /* defensive */
+        }
+#endif
+        /* Skip pages without damage */
+        while (g_async.page < SSD1306_RAM_PAGES &&
+               (g_async.page_mask & (1u << g_async.page)) == 0u) {
+          g_async.page++;
+        }
+        if (g_async.page >= SSD1306_RAM_PAGES) {
+#if GFX_TILE_BUFFERS > 1
+          if (g_async.in_flight) {
+            return; /* last page still streaming */
+          }
+#endif
+          ssd1306_async_frame_done();
+          return;
+        }
+        debug_log_event(DEBUG_LED_EVT_RENDER_STAGE, (uint8_t) (g_async.page & 0x07u));
+        gfx_clear_shared_buffer();
+#if SSD1306_PERF_STATS
+        uint32_t build_mark = SysTick->CNT;
+#endif
+        if (g_async.cb) {
+          g_async.cb(g_async.page);
+        }
+#if SSD1306_PERF_STATS
+        ssd1306_perf_add(ssd1306_perf_elapsed_us(build_mark),
+                         &g_perf.build_min_us,
+                         &g_perf.build_max_us,
+                         &g_perf.build_sum_us);
+        g_perf.builds++;
+#endif
+        g_async.stage = SSD1306_ASYNC_STAGE_ADDR;
+        break;
       }
-      /* Page transfer complete */
-      g_async.page++;
-      if (g_async.page >= g_pages) {
-        debug_log_event(DEBUG_LED_EVT_RENDER_DONE,
-                        g_async.rerender_pending ? 1u : 0u);
-        g_async.active = 0;
-        if (g_async.rerender_pending) {
-          g_async.rerender_pending = 0;
-          g_async.active           = 1;
-          g_async.page             = 0;
-          g_async.stage            = SSD1306_ASYNC_STAGE_ADDR;
-          debug_log_event(DEBUG_LED_EVT_RENDER_START,
-                          (uint8_t) ((g_pages > 0U) ? (g_pages - 1U) : 0U));
+      case SSD1306_ASYNC_STAGE_ADDR:
+#if GFX_TILE_BUFFERS == 1
+        if (i2c_tx_dma_busy()) {
+          return; /* wait if something else sending */
+        }
+#endif
+        g_async.seg_first = g_async.col_first;
+        g_async.seg_last  = g_async.col_last;
+#if SSD1306_PAGE_HASH_SEGMENTS > 0
+        if (ssd1306_hash_narrow(g_async.page, &g_async.seg_first, &g_async.seg_last) == 0u) {
+          /* Panel already shows these bytes; no transfer */
+          ssd1306_async_next_page();
+          break;
+        }
+#endif
+        g_async.stage = SSD1306_ASYNC_STAGE_STREAM_START;
+        break;
+      case SSD1306_ASYNC_STAGE_STREAM_START:
+        if (i2c_tx_dma_busy()) {
+          return; /* ensure bus free */
         }
+#if GFX_TILE_BUFFERS > 1
+        if (g_async.in_flight) {
+          return; /* previous page still draining */
+        }
+#endif
+        ssd1306_async_launch_page();
+        break;
+      case SSD1306_ASYNC_STAGE_STREAMING:
+#if SSD1306_XFER_IRQ_CHAIN
+        /* The transfer-complete interrupt finishes the page */
         return;
-      }
-      g_async.stage = SSD1306_ASYNC_STAGE_ADDR;
-      break;
-    default:
-      g_async.active = 0; /* invalid state fallback */
-      break;
+#else
+        if (g_xfer.active) {
+          /* Still streaming chunks */
+          return;
+        }
+        /* Page transfer complete */
+        ssd1306_async_stream_done();
+        if (g_async.page >= SSD1306_RAM_PAGES) {
+          ssd1306_async_frame_done();
+          return;
+        }
+        break;
+#endif
+      default:
+        g_async.active = 0; /* invalid state fallback */
+        break;
+    }
+#if SSD1306_XFER_IRQ_CHAIN
+    /* Compare and launch a freshly built page in the same call; the bus then idles only
+       while the next page builds */
+    if (g_async.active && (g_async.stage == SSD1306_ASYNC_STAGE_ADDR ||
+                           g_async.stage == SSD1306_ASYNC_STAGE_STREAM_START)) {
+      continue;
+    }
+#endif
+    break;
   }
 }
 
@@ -275,12 +834,15 @@ int ssd1306_send_data_bulk(const uint8_t* data_bytes, int count)
 {
   return ssd1306_dma_xfer_block(0x40, data_bytes, count);
 }
-/* Set full column range and the given page range in one burst to shrink code size */
-static void ssd1306_set_addr(uint8_t page_start, uint8_t page_end)
+/* Set the column and page window in one burst to shrink code size */
+static void ssd1306_set_addr(uint8_t page_start,
+                             uint8_t page_end,
+                             uint8_t col_start,
+                             uint8_t col_end)
 {
   uint8_t seq[6] = {SSD1306_CMD_SET_COL_ADDR,
-                    0x00,
-                    (uint8_t) (SSD1306_WIDTH - 1),
+                    col_start,
+                    col_end,
                     SSD1306_CMD_SET_PAGE_ADDR,
                     page_start,
                     page_end};
@@ -290,6 +852,8 @@ static void ssd1306_set_addr(uint8_t page_start, uint8_t page_end)
 int ssd1306_init(void)
 {
   i2c_init(&g_i2c_dev);
+  i2c_set_tx_done_callback(ssd1306_dma_xfer_irq);
+  ssd1306_hash_reset();
 
   /* Initialization sequence consolidated per SSD1306 datasheet */
   /* Order kept same as original discrete calls. */
@@ -330,8 +894,10 @@ void ssd1306_clear(void)
 {
   /* Zero a single 128-byte tile and write it to each page */
   gfx_clear_shared_buffer();
+  ssd1306_hash_reset();
+  ssd1306_start_line_reset();
   for (uint8_t page = 0; page < g_pages; page++) {
-    ssd1306_set_addr(page, page);
+    ssd1306_set_addr(page, page, 0u, (uint8_t) (SSD1306_WIDTH - 1));
     if (ssd1306_send_data_bulk(gfx_get_shared_buffer(), SSD1306_WIDTH) != 0) {
       return;
     }
@@ -383,7 +949,9 @@ int ssd1306_write_page(uint8_t page, const uint8_t* data)
   if (page >= g_pages) {
     return RES_BAD_LEN;
   }
-  ssd1306_set_addr(page, page);
+  ssd1306_hash_reset();
+  ssd1306_start_line_reset();
+  ssd1306_set_addr(page, page, 0u, (uint8_t) (SSD1306_WIDTH - 1));
   return ssd1306_send_data_bulk(data, SSD1306_WIDTH);
 }
 
@@ -417,6 +985,9 @@ int ssd1306_set_height(uint8_t height)
   }
   g_height = height;
   g_pages  = (uint8_t) (g_height / SSD1306_PAGE_HEIGHT);
+  ssd1306_invalidate_all();
+  ssd1306_hash_reset();
+  ssd1306_start_line_reset();
   /* Apply geometry-related commands: multiplex and page address range for next ops. */
   uint8_t seq[] = {
     SSD1306_CMD_SET_MULTIPLEX, 
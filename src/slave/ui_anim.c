@@ -0,0 +1,125 @@
+/**
+ * @file ui_anim.c
+ * @brief Time-based sampling of the screen slide, list scroll and edit blink.
+ */
+#include "ui_anim.h"
+
+#include "ui_focus.h"
+#include "ui_protocol.h"
+#include "ui_runtime.h"
+
+uint16_t ui_anim_ease_q8(uint16_t elapsed_ms, uint16_t duration_ms)
+{
+  if (duration_ms == 0u || elapsed_ms >= duration_ms) {
+    return UI_ANIM_Q8_ONE;
+  }
+  uint32_t t = ((uint32_t) elapsed_ms << 8) / duration_ms; /* 0..255 */
+#if UI_ANIM_EASING
+  /* smoothstep: t^2 * (3 - 2t), all terms in Q8 */
+  return (uint16_t) ((t * t * (3u * UI_ANIM_Q8_ONE - 2u * t)) >> 16);
+#else
+  return (uint16_t) t;
+#endif
+}
+
+/** Move the slide offset; the last sample snaps to the target screen. */
+static void ui_anim_sample_slide(uint16_t now_ms)
+{
+  screen_anim_state_t* sa = &g_protocol_state.screen_anim;
+  if (!sa->active) {
+    return;
+  }
+  uint16_t elapsed = (uint16_t) (now_ms - sa->start_ms);
+  if (elapsed >= (uint16_t) SCREEN_ANIM_DURATION_MS) {
+    sa->active    = 0;
+    sa->offset_px = 0;
+    protocol_invalidate_visibility();
+    /* Snap base scroll to new active screen position */
+    g_protocol_state.scroll_x = (int16_t) g_protocol_state.active_screen * 128;
+    /* Re-assign focus now that the slide animation has finished */
+    protocol_focus_first_on_screen(g_protocol_state.active_screen);
+    protocol_request_render();
+    return;
+  }
+  int16_t offset =
+      (int16_t) ((ui_anim_ease_q8(elapsed, (uint16_t) SCREEN_ANIM_DURATION_MS) * 128u) >> 8);
+  if (offset != sa->offset_px) {
+    sa->offset_px = offset;
+    protocol_request_render();
+  }
+}
+
+/** Move one list row scroll; start-line steps cover every pixel skipped since the last frame. */
+static void ui_anim_sample_list(ur_list_state_t* ls, uint16_t now_ms)
+{
+  uint16_t elapsed = (uint16_t) (now_ms - ls->anim_start_ms);
+  uint8_t  target =
+      (uint8_t) ((ui_anim_ease_q8(elapsed, (uint16_t) LIST_ANIM_DURATION_MS) * 8u) >> 8);
+  if (target == ls->anim_pix) {
+    return;
+  }
+  uint8_t hw_scroll = 0u;
+#if LIST_ANIM_START_LINE_SCROLL
+  if (!g_protocol_state.screen_anim.active) {
+    hw_scroll = render_list_owns_panel(ls->element_id);
+  }
+  if (hw_scroll != 0u) {
+    protocol_scroll_list_lines(ls->element_id,
+                               (int8_t) (ls->anim_dir * (int8_t) (target - ls->anim_pix)));
+  }
+#endif
+  ls->anim_pix = target;
+  if (target >= 8u) {
+    ls->top_index   = ls->pending_top;
+    ls->cursor      = ls->pending_cursor;
+    ls->anim_active = 0;
+    ls->anim_dir    = 0;
+    ls->anim_pix    = 0;
+    /* After a start-line scroll the marker of the row scrolled away from disappears */
+    hw_scroll = 0u;
+  }
+  if (hw_scroll == 0u) {
+    protocol_request_render_element(ls->element_id);
+  }
+}
+
+/** Flip the blink phase once per EDIT_BLINK_PHASE_MS, keeping the phase grid anchored. */
+static void ui_anim_sample_blink(uint16_t now_ms)
+{
+  if (g_protocol_state.edit_blink_active == 0u) {
+    return;
+  }
+  uint16_t elapsed = (uint16_t) (now_ms - g_protocol_state.edit_blink_start_ms);
+  if (elapsed < (uint16_t) EDIT_BLINK_PHASE_MS) {
+    return;
+  }
+  uint16_t phases = (uint16_t) (elapsed / (uint16_t) EDIT_BLINK_PHASE_MS);
+  g_protocol_state.edit_blink_start_ms =
+      (uint16_t) (g_protocol_state.edit_blink_start_ms + phases * (uint16_t) EDIT_BLINK_PHASE_MS);
+  if ((phases & 1u) != 0u) {
+    g_protocol_state.edit_blink_phase = (uint8_t) (g_protocol_state.edit_blink_phase ^ 1u);
+    /* Only the barrel being edited (focused) blinks */
+    protocol_request_render_element(g_protocol_state.focused_element);
+  }
+}
+
+void ui_anim_sample(uint16_t now_ms)
+{
+  ui_anim_sample_slide(now_ms);
+  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+    ur_list_state_t* ls = ur_list_find(&g_protocol_state.runtime, i);
+    if (ls && ls->anim_active) {
+      ui_anim_sample_list(ls, now_ms);
+    }
+  }
+  ui_anim_sample_blink(now_ms);
+}
+
+void ui_anim_frame_begin(void)
+{
+  /* The driver latches damage after this hook, so what moves lands in this frame and
+     needs no follow-up frame. */
+  uint8_t requested = g_render_requested;
+  ui_anim_sample((uint16_t) get_system_time_ms());
+  g_render_requested = requested;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file ui_edit.c
+ * @brief Post-COMMIT structural edits: append child, remove subtree.
+ *
+ * An edit permutes the per-element tables that hold provisioned data (parent/type, position,
+ * base screen marker, runtime slot), renumbers attribute entries and runtime nodes in place,
+ * rebuilds the derived tables and carries focus, navigation and the active screen across.
+ * Nothing is resent: the cost is the edited object plus a pass over the arena.
+ */
+#include "ui_edit.h"
+
+#include <string.h>
+
+#include "status_codes.h"
+#include "ui_focus.h"
+#include "ui_protocol.h"
+#include "ui_tree.h"
+
+/** Apply a remap to one per-element table of width-byte entries (count = ids before the edit). */
+static void edit_permute(uint8_t* table, uint8_t width, const ur_remap_t* m, uint8_t count)
+{
+  uint16_t a = (uint16_t) ((uint16_t) m->a * width);
+  uint16_t b = (uint16_t) ((uint16_t) m->b * width);
+  if (m->op == UR_REMAP_REMOVE) {
+    memmove(&table[a], &table[b], (uint16_t) ((uint16_t) count * width - b));
+  } else if (m->op == UR_REMAP_MOVE) {
+    uint8_t keep[sizeof(element_t)];
+    memcpy(keep, &table[b], width);
+    memmove(&table[a + width], &table[a], (uint16_t) (b - a));
+    memcpy(&table[a], keep, width);
+  }
+}
+
+/** Renumber the provisioned per-element tables and clear the entries freed at the end. */
+static void edit_permute_tables(const ur_remap_t* m)
+{
+  uint8_t count = g_protocol_state.element_count;
+  edit_permute((uint8_t*) g_protocol_state.elements, (uint8_t) sizeof(element_t), m, count);
+  edit_permute(g_protocol_state.pos_x, 1u, m, count);
+  edit_permute(g_protocol_state.pos_y, 1u, m, count);
+  edit_permute(g_protocol_state.screen_ords, 1u, m, count);
+  edit_permute(g_protocol_state.runtime_slot, 1u, m, count);
+  if (m->op == UR_REMAP_REMOVE) {
+    uint8_t gone = (uint8_t) (m->b - m->a);
+    uint8_t n    = (uint8_t) (count - gone);
+    memset(&g_protocol_state.elements[n], 0xFF, (uint16_t) gone * (uint16_t) sizeof(element_t));
+    memset(&g_protocol_state.pos_x[n], 0, gone);
+    memset(&g_protocol_state.pos_y[n], 0, gone);
+    memset(&g_protocol_state.screen_ords[n], INVALID_ELEMENT_ID, gone);
+    memset(&g_protocol_state.runtime_slot[n], 0, gone);
+    g_protocol_state.element_count = n;
+  }
+  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+    g_protocol_state.elements[i].parent_id = ur_remap_id(m, g_protocol_state.elements[i].parent_id);
+  }
+}
+
+/** Re-derive list rows, bookkeeping and the trigger count from the edited child chains. */
+static void edit_fix_lists(void)
+{
+  ui_runtime_t* rt               = &g_protocol_state.runtime;
+  g_protocol_state.trigger_count = 0u;
+  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+    if (g_protocol_state.elements[i].type == ELEMENT_TRIGGER) {
+      g_protocol_state.trigger_count++;
+    }
+    ur_list_state_t* ls = ur_list_find(rt, i);
+    if (!ls) {
+      continue;
+    }
+    uint8_t rows = 0u;
+    uint8_t last = INVALID_ELEMENT_ID;
+    for (uint8_t t = element_next_child(i, INVALID_ELEMENT_ID, ELEMENT_TEXT);
+         t != INVALID_ELEMENT_ID;
+         t = element_next_child(i, t, ELEMENT_TEXT)) {
+      g_protocol_state.pos_y[t] = (uint8_t) (rows * 8u); /* row y as at creation */
+      last                      = t;
+      rows++;
+    }
+    ls->last_text_child = last;
+    if (ls->cursor >= rows || ls->pending_cursor >= rows) {
+      /* Rows went away under the cursor: stop the scroll and clamp */
+      uint8_t cursor     = (rows != 0u) ? (uint8_t) (rows - 1u) : 0u;
+      ls->anim_active    = 0u;
+      ls->anim_dir       = 0;
+      ls->anim_pix       = 0u;
+      ls->cursor         = (ls->cursor < cursor) ? ls->cursor : cursor;
+      ls->pending_cursor = ls->cursor;
+      ls->top_index      = (ls->top_index < ls->cursor) ? ls->top_index : ls->cursor;
+      ls->pending_top    = ls->top_index;
+    }
+  }
+}
+
+/** Carry focus, overlay, navigation and the active screen (element id before the edit). */
+static void edit_remap_state(const ur_remap_t* m, uint8_t active_id)
+{
+  protocol_state_t* st      = &g_protocol_state;
+  uint8_t           focus   = ur_remap_id(m, st->focused_element);
+  uint8_t           lost    = (focus != st->focused_element && focus == INVALID_ELEMENT_ID) ? 1u : 0u;
+  uint8_t           overlay = st->overlay.active_overlay_screen_id;
+  st->focused_element                  = focus;
+  st->status_dirty_id                  = ur_remap_id(m, st->status_dirty_id);
+  st->overlay.prev_focus               = ur_remap_id(m, st->overlay.prev_focus);
+  st->overlay.active_overlay_screen_id = ur_remap_id(m, overlay);
+  /* Unwind navigation at the first level whose target or return list went away */
+  uint8_t depth = 0u;
+  while (depth < st->nav_depth && depth < NAV_STACK_MAX_DEPTH) {
+    nav_stack_entry_t* e      = &st->nav_stack[depth];
+    uint8_t            target = ur_remap_id(m, e->target_element);
+    uint8_t            ret    = ur_remap_id(m, e->return_list);
+    if (target == INVALID_ELEMENT_ID || (ret == INVALID_ELEMENT_ID && ret != e->return_list)) {
+      break;
+    }
+    uint8_t sord = find_screen_ordinal_by_id(ur_remap_id(m, e->saved_active_screen));
+    e->target_element      = target;
+    e->return_list         = ret;
+    e->saved_focus         = ur_remap_id(m, e->saved_focus);
+    e->saved_active_screen = (sord == INVALID_ELEMENT_ID) ? 0u : sord;
+    depth++;
+  }
+  if (depth != st->nav_depth) {
+    st->nav_depth = depth;
+    lost          = 1u;
+  }
+  st->active_local_screen = INVALID_ELEMENT_ID;
+  if (depth != 0u && st->nav_stack[depth - 1u].type == (uint8_t) NAV_CTX_LOCAL_SCREEN) {
+    st->active_local_screen = st->nav_stack[depth - 1u].target_element;
+  }
+  uint8_t sord = find_screen_ordinal_by_id(ur_remap_id(m, active_id));
+  if (sord == INVALID_ELEMENT_ID) {
+    sord = 0u;
+  }
+  if (sord != st->active_screen || st->screen_anim.active != 0u) {
+    st->active_screen           = sord;
+    st->scroll_x                = (int16_t) ((int16_t) sord * SSD1306_WIDTH);
+    st->screen_anim.active      = 0u;
+    st->screen_anim.offset_px   = 0;
+    st->screen_anim.dir         = 0;
+    st->screen_anim.from_screen = sord;
+    st->screen_anim.to_screen   = sord;
+  }
+  protocol_invalidate_visibility();
+  if (overlay != INVALID_ELEMENT_ID && st->overlay.active_overlay_screen_id == INVALID_ELEMENT_ID) {
+    st->overlay.remaining_ms = 0u;
+    st->overlay.mask_input   = 0u;
+    protocol_overlay_cleared();
+  } else if (lost != 0u && st->overlay.active_overlay_screen_id == INVALID_ELEMENT_ID) {
+    st->edit_blink_active = 0u;
+    if (depth == 0u) {
+      protocol_focus_first_on_screen(st->active_screen);
+    } else {
+      protocol_set_focus(st->nav_stack[depth - 1u].target_element);
+    }
+  }
+}
+
+/** Apply one remap to the whole arena and the protocol state, then redraw. */
+static void edit_apply(const ur_remap_t* m)
+{
+  protocol_state_t* st     = &g_protocol_state;
+  uint8_t           active = find_screen_id_by_ordinal(st->active_screen);
+  /* Ordinals shift with the base screens: carry the saved ones across as element ids */
+  for (uint8_t i = 0; i < st->nav_depth && i < NAV_STACK_MAX_DEPTH; i++) {
+    st->nav_stack[i].saved_active_screen =
+      find_screen_id_by_ordinal(st->nav_stack[i].saved_active_screen);
+  }
+  if (m->op != UR_REMAP_NONE) {
+    edit_permute_tables(m);
+    ui_attr_remap(&st->runtime, m);
+  }
+  ur_compact(&st->runtime);
+  element_rebuild_tables();
+  edit_remap_state(m, active);
+  edit_fix_lists();
+  if (st->initialized != 0u) {
+    list_build_row_tables();
+  }
+  protocol_request_render();
+}
+
+uint8_t ui_edit_begin(void)
+{
+  /* Row tables are rebuilt at the end; packing now leaves the create all free space */
+  ur_compact(&g_protocol_state.runtime);
+  return g_protocol_state.preorder;
+}
+
+void ui_edit_place_created(uint8_t first_new, uint8_t preorder)
+{
+  ur_remap_t m = {UR_REMAP_NONE, 0u, 0u};
+  if (preorder != 0u && g_protocol_state.preorder == 0u &&
+      g_protocol_state.element_count == (uint8_t) (first_new + 1u)) {
+    /* Ids below the new element are still in pre-order: the end of the final parent's subtree */
+    uint8_t parent = g_protocol_state.elements[first_new].parent_id;
+    uint8_t end    = (parent < first_new) ? element_range_end(parent, first_new) : first_new;
+    if (end < first_new) {
+      m.op = UR_REMAP_MOVE;
+      m.a  = end;
+      m.b  = first_new;
+    }
+  }
+  edit_apply(&m);
+}
+
+int ui_edit_remove_subtree(uint8_t eid)
+{
+  if (eid >= g_protocol_state.element_count) {
+    return RES_UNKNOWN_ID;
+  }
+  if (g_protocol_state.preorder == 0u) {
+    return RES_BAD_STATE;
+  }
+  ur_remap_t m = {UR_REMAP_REMOVE, eid, element_subtree_end(eid)};
+  edit_apply(&m);
+  return RES_OK;
+}
@@ -4,6 +4,8 @@
  */
 #include "ui_focus.h"
 
+#include <string.h>
+
 #include "ui_protocol.h"
 #include "ui_runtime.h"
 #include "ui_tree.h"
@@ -71,11 +73,9 @@ static uint8_t screen_is_local(uint8_t screen_id)
   return (g_protocol_state.elements[parent].type == ELEMENT_TEXT) ? 1u : 0u;
 }
 
-uint8_t protocol_is_element_visible(uint8_t eid)
+/** Resolve visibility of one element from the navigation and screen state. */
+static uint8_t visibility_resolve(uint8_t eid)
 {
-  if (eid >= g_protocol_state.element_count) {
-    return 0u;
-  }
   uint8_t context      = nav_active_context();
   uint8_t extra_screen = INVALID_ELEMENT_ID;
   if (g_protocol_state.nav_depth == 0u && g_protocol_state.screen_anim.active != 0u) {
@@ -144,6 +144,30 @@ uint8_t protocol_is_element_visible(uint8_t eid)
   return 1u;
 }
 
+void protocol_invalidate_visibility(void)
+{
+  g_protocol_state.visible_valid = 0u;
+}
+
+uint8_t protocol_is_element_visible(uint8_t eid)
+{
+  if (eid >= g_protocol_state.element_count) {
+    return 0u;
+  }
+  uint8_t* bits = g_protocol_state.visible_bits;
+  if (g_protocol_state.visible_valid == 0u) {
+    uint8_t count = g_protocol_state.element_count;
+    memset(bits, 0, (uint8_t) ((count + 7u) / 8u));
+    for (uint8_t i = 0; i < count; i++) {
+      if (visibility_resolve(i) != 0u) {
+        bits[i >> 3] |= (uint8_t) (1u << (i & 7u));
+      }
+    }
+    g_protocol_state.visible_valid = 1u;
+  }
+  return (uint8_t) ((bits[eid >> 3] >> (eid & 7u)) & 1u);
+}
+
 /** Return non-zero if the element type participates in focus traversal. */
 static int element_focusable(uint8_t eid)
 {
@@ -163,7 +187,8 @@ static int element_focusable(uint8_t eid)
 /** Focus the first visible focusable element under the given owner. */
 static void protocol_focus_first_under(uint8_t owner_id)
 {
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+  uint8_t end = element_subtree_end(owner_id);
+  for (uint8_t i = owner_id; i < end; i++) {
     if (protocol_is_element_visible(i) == 0u) {
       continue;
     }
@@ -187,7 +212,7 @@ void protocol_register_local_screen(uint8_t screen_id, uint8_t owner_text)
     owner_text = INVALID_ELEMENT_ID;
   }
   if (owner_text != INVALID_ELEMENT_ID) {
-    g_protocol_state.elements[screen_id].parent_id = owner_text;
+    element_set_parent(screen_id, owner_text);
   }
 }
 
@@ -196,13 +221,7 @@ uint8_t protocol_text_local_screen(uint8_t text_id)
   if (text_id >= g_protocol_state.element_count) {
     return INVALID_ELEMENT_ID;
   }
-  for (uint8_t eid = 0; eid < g_protocol_state.element_count; eid++) {
-    if (g_protocol_state.elements[eid].parent_id == text_id &&
-        g_protocol_state.elements[eid].type == ELEMENT_SCREEN) {
-      return eid;
-    }
-  }
-  return INVALID_ELEMENT_ID;
+  return element_next_child(text_id, INVALID_ELEMENT_ID, ELEMENT_SCREEN);
 }
 
 uint8_t nav_push_list(uint8_t parent_list, uint8_t target_list)
@@ -229,6 +248,7 @@ uint8_t nav_push_list(uint8_t parent_list, uint8_t target_list)
   child_state->anim_pix     = 0u;
   child_state->anim_dir     = 0;
   g_protocol_state.nav_depth = (uint8_t) (g_protocol_state.nav_depth + 1u);
+  protocol_invalidate_visibility();
   nav_update_active_local_screen();
   protocol_set_focus(target_list);
   return 1u;
@@ -257,6 +277,7 @@ uint8_t nav_push_local_screen(uint8_t parent_list, uint8_t screen_id)
     g_protocol_state.scroll_x      = (int16_t) ((int16_t) new_ord * 128);
   }
   g_protocol_state.nav_depth = (uint8_t) (g_protocol_state.nav_depth + 1u);
+  protocol_invalidate_visibility();
   nav_update_active_local_screen();
   protocol_focus_first_under(screen_id);
   if (g_protocol_state.focused_element == INVALID_ELEMENT_ID) {
@@ -276,6 +297,7 @@ uint8_t nav_pop(void)
   }
   nav_stack_entry_t entry = g_protocol_state.nav_stack[top_index];
   g_protocol_state.nav_depth = top_index;
+  protocol_invalidate_visibility();
   nav_update_active_local_screen();
   if (entry.return_list != INVALID_ELEMENT_ID) {
     ur_list_state_t* parent_state =
@@ -290,6 +312,7 @@ uint8_t nav_pop(void)
   }
   if (entry.type == (uint8_t) NAV_CTX_LOCAL_SCREEN) {
     g_protocol_state.active_screen = entry.saved_active_screen;
+    protocol_invalidate_visibility();
     g_protocol_state.scroll_x      = (int16_t) ((int16_t) g_protocol_state.active_screen * 128);
   }
   if (entry.return_list != INVALID_ELEMENT_ID) {
@@ -387,7 +410,8 @@ void protocol_focus_first_on_screen(uint8_t sord)
     protocol_clear_focus();
     return;
   }
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+  uint8_t end = element_subtree_end(screen_eid);
+  for (uint8_t i = screen_eid; i < end; i++) {
     if (protocol_is_element_visible(i) == 0u) {
       continue;
     }
@@ -55,9 +55,9 @@ static uint8_t list_effective_window(uint8_t list_eid, const ur_list_state_t* st
 /** Start edit-mode blink animation. */
 static void protocol_edit_blink_start(void)
 {
-  g_protocol_state.edit_blink_active  = 1u;
-  g_protocol_state.edit_blink_phase   = 1u;
-  g_protocol_state.edit_blink_counter = 0u;
+  g_protocol_state.edit_blink_active   = 1u;
+  g_protocol_state.edit_blink_phase    = 1u;
+  g_protocol_state.edit_blink_start_ms = (uint16_t) get_system_time_ms();
 }
 
 /** Return 1 if any barrel element is currently in edit mode. */
@@ -82,9 +82,8 @@ static void protocol_edit_blink_stop_if_unused(void)
   if (protocol_edit_blink_any_active() != 0u) {
     return;
   }
-  g_protocol_state.edit_blink_active  = 0u;
-  g_protocol_state.edit_blink_phase   = 1u;
-  g_protocol_state.edit_blink_counter = 0u;
+  g_protocol_state.edit_blink_active = 0u;
+  g_protocol_state.edit_blink_phase  = 1u;
 }
 
 /** Enter edit mode for a barrel element and snapshot its current value. */
@@ -126,11 +125,10 @@ static void barrel_commit_edit(uint8_t eid)
 static uint8_t barrel_options_count(uint8_t barrel_id)
 {
   uint8_t count = 0;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* el = &g_protocol_state.elements[i];
-    if (el->parent_id == barrel_id && el->type == ELEMENT_TEXT) {
-      count++;
-    }
+  for (uint8_t i = element_next_child(barrel_id, INVALID_ELEMENT_ID, ELEMENT_TEXT);
+       i != INVALID_ELEMENT_ID;
+       i = element_next_child(barrel_id, i, ELEMENT_TEXT)) {
+    count++;
   }
   return count;
 }
@@ -269,8 +267,10 @@ static uint8_t handle_screen_slide(ui_action_t action)
     sa->to_screen   = target;
     sa->offset_px   = 0;
     sa->dir         = -1;
+    sa->start_ms    = (uint16_t) get_system_time_ms();
     g_protocol_state.scroll_x      = (int16_t) sa->from_screen * 128;
     g_protocol_state.active_screen = target;
+    protocol_invalidate_visibility();
     protocol_clear_focus();
     return 1u;
   }
@@ -288,8 +288,10 @@ static uint8_t handle_screen_slide(ui_action_t action)
     sa->to_screen   = target;
     sa->offset_px   = 0;
     sa->dir         = +1;
+    sa->start_ms    = (uint16_t) get_system_time_ms();
     g_protocol_state.scroll_x      = (int16_t) sa->from_screen * 128;
     g_protocol_state.active_screen = target;
+    protocol_invalidate_visibility();
     protocol_clear_focus();
     return 1u;
   }
@@ -326,6 +328,7 @@ static void list_move_cursor(uint8_t list_id, int8_t dir)
         ls->anim_active    = 1u;
         ls->anim_dir       = -1;
         ls->anim_pix       = 0u;
+        ls->anim_start_ms  = (uint16_t) get_system_time_ms();
         ls->pending_cursor = new_cursor;
         ls->pending_top    = new_top;
       } else {
@@ -339,6 +342,7 @@ static void list_move_cursor(uint8_t list_id, int8_t dir)
         ls->anim_active    = 1u;
         ls->anim_dir       = +1;
         ls->anim_pix       = 0u;
+        ls->anim_start_ms  = (uint16_t) get_system_time_ms();
         ls->pending_cursor = new_cursor;
         ls->pending_top    = (uint8_t) (ls->top_index + 1u);
       } else {
@@ -346,6 +350,7 @@ static void list_move_cursor(uint8_t list_id, int8_t dir)
       }
     }
   }
+  protocol_request_render_element(list_id);
 }
 
 /** Resolve the selected text element for a list (returns 0 if none). */
@@ -380,13 +385,7 @@ static uint8_t list_selected_text(uint8_t list_id, uint8_t* out_text_id)
 /** Find a nested list child under a text element. */
 static uint8_t list_find_nested_list(uint8_t text_id)
 {
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    if (g_protocol_state.elements[i].parent_id == text_id &&
-        g_protocol_state.elements[i].type == ELEMENT_LIST_VIEW) {
-      return i;
-    }
-  }
-  return INVALID_ELEMENT_ID;
+  return element_next_child(text_id, INVALID_ELEMENT_ID, ELEMENT_LIST_VIEW);
 }
 
 /** Resolve the OK action target for the selected list row. */
@@ -529,25 +528,29 @@ static void barrel_change_option(uint8_t barrel_id, int8_t dir)
   numeric_set_value(barrel_id, index);
 }
 
-/** Handle UP/DOWN actions using the current focus kind. */
-static void handle_action_updown(const ui_input_ctx_t* ctx, int8_t dir)
+/**
+ * Handle UP/DOWN actions using the current focus kind.
+ * @return 1 when the change already recorded its own damage, 0 when a full redraw is needed.
+ */
+static uint8_t handle_action_updown(const ui_input_ctx_t* ctx, int8_t dir)
 {
   if (ctx == NULL) {
-    return;
+    return 0u;
   }
   if (ctx->focus_kind == UI_FOCUS_LIST) {
     list_move_cursor(ctx->focused_id, dir);
-    return;
+    return 1u;
   }
   if (ctx->focus_kind == UI_FOCUS_BARREL && ctx->barrel_editing != 0u) {
     barrel_change_option(ctx->focused_id, dir);
-    return;
+    return 1u;
   }
   if (dir < 0) {
     protocol_focus_prev();
   } else {
     protocol_focus_next();
   }
+  return 0u;
 }
 
 /** Handle OK actions using the current focus kind. */
@@ -638,32 +641,33 @@ static void handle_action_back(const ui_input_ctx_t* ctx)
   }
 }
 
-/** Handle a button release event and update UI state. */
-static void process_button_release(uint8_t button)
+/**
+ * Handle a button release event and update UI state.
+ * @return 1 when the change already recorded its own damage, 0 when a full redraw is needed.
+ */
+static uint8_t process_button_release(uint8_t button)
 {
   ui_action_t action = ui_action_from_button(button);
   if (action == UI_ACTION_INVALID) {
-    return;
+    return 0u;
   }
   if (g_protocol_state.screen_anim.active) {
-    return;
+    return 0u;
   }
   if (action == UI_ACTION_UP && protocol_up_button_pressed) {
     protocol_up_button_pressed();
   }
   if (action == UI_ACTION_LEFT || action == UI_ACTION_RIGHT) {
     (void) handle_screen_slide(action);
-    return;
+    return 0u;
   }
 
   ui_input_ctx_t ctx = ui_input_ctx_collect();
   switch (action) {
     case UI_ACTION_UP:
-      handle_action_updown(&ctx, -1);
-      break;
+      return handle_action_updown(&ctx, -1);
     case UI_ACTION_DOWN:
-      handle_action_updown(&ctx, +1);
-      break;
+      return handle_action_updown(&ctx, +1);
     case UI_ACTION_OK:
       handle_action_ok(&ctx);
       break;
@@ -673,6 +677,7 @@ static void process_button_release(uint8_t button)
     default:
       break;
   }
+  return 0u;
 }
 
 int cmd_input_event(uint8_t* p, uint8_t l)
@@ -692,8 +697,9 @@ int cmd_input_event(uint8_t* p, uint8_t l)
     }
   }
   if (evt == 0) {
-    process_button_release(idx);
-    protocol_request_render();
+    if (process_button_release(idx) == 0u) {
+      protocol_request_render();
+    }
   }
   return RES_OK;
 }
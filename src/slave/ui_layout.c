@@ -32,33 +32,16 @@ int ui_layout_compute_element(uint8_t element_id, int16_t* out_x, int16_t* out_y
     return RES_BAD_STATE;
   }
 
-  uint8_t owning_screen = INVALID_ELEMENT_ID;
-  if (g_protocol_state.elements[element_id].type == ELEMENT_SCREEN &&
-      g_protocol_state.elements[element_id].parent_id == INVALID_ELEMENT_ID) {
-    owning_screen = element_id;
-  } else {
-    uint8_t parent = g_protocol_state.elements[element_id].parent_id;
-    while (parent != INVALID_ELEMENT_ID) {
-      if (g_protocol_state.elements[parent].type == ELEMENT_SCREEN &&
-          g_protocol_state.elements[parent].parent_id == INVALID_ELEMENT_ID) {
-        owning_screen = parent;
-        break;
-      }
-      parent = g_protocol_state.elements[parent].parent_id;
-    }
-  }
+  uint8_t owning_screen = element_top_screen(element_id);
   if (owning_screen == INVALID_ELEMENT_ID) {
     return RES_UNKNOWN_ID;
   }
 
   int16_t base_x = (int16_t) x;
   int16_t base_y = (int16_t) y;
-  uint8_t role = protocol_screen_role(owning_screen);
-  if (role == OVERLAY_NONE) {
-    uint8_t screen_ord = find_screen_ordinal_by_id(owning_screen);
-    if (screen_ord == INVALID_ELEMENT_ID) {
-      return RES_UNKNOWN_ID;
-    }
+  /* Overlay screens have no base ordinal and are not scrolled */
+  uint8_t screen_ord = find_screen_ordinal_by_id(owning_screen);
+  if (screen_ord != INVALID_ELEMENT_ID) {
     base_x += (int16_t) ((int16_t) screen_ord * SSD1306_WIDTH);
     base_x -= g_protocol_state.scroll_x;
     if (g_protocol_state.screen_anim.active) {
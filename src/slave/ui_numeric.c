@@ -38,7 +38,10 @@ void numeric_set_value(uint8_t id, int value)
   if (!st) {
     return;
   }
-  st->value = (int16_t) value;
+  if (st->value != (int16_t) value) {
+    st->value = (int16_t) value;
+    protocol_request_render_element(id);
+  }
 }
 
 void numeric_set_aux(uint8_t id, uint8_t aux)
@@ -0,0 +1,295 @@
+/**
+ * @file ui_persist.c
+ * @brief Committed UI image in flash: save after provisioning, restore at boot.
+ *
+ * Image layout in the flash store: header, string table, then the arena head [0, head_used),
+ * then the arena tail [cap - used_tail, cap). Everything in the arena is offset-addressed, and
+ * the table pointers follow from the element capacity, so restoring is a reserve plus two
+ * copies. The header page is written last and the image hash covers every byte, so an
+ * interrupted save reads back as "no image".
+ *
+ * The string table only grows while the arena references it: a save appends the static texts
+ * still in RAM and then shrinks their entries to references, so earlier offsets stay valid.
+ * A JSON HEAD drops every reference and the next save starts the table over.
+ */
+#include "ui_persist.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "flash_store.h"
+#include "status_codes.h"
+#include "ui_protocol.h"
+#include "ui_tree.h"
+
+/** Flash image header (little-endian, as stored). */
+typedef struct UI_ATTR_PACKED {
+  uint8_t  magic[2];      /**< 'U','I' */
+  uint8_t  version;       /**< UI_PERSIST_VERSION */
+  uint8_t  layout;        /**< Arena layout knobs of the build that wrote the image */
+  uint16_t arena_cap;     /**< UI_ATTR_ARENA_CAP of that build */
+  uint16_t head_used;     /**< Arena head bytes that follow the header */
+  uint16_t used_tail;     /**< Arena tail bytes after the head bytes */
+  uint16_t str_used;      /**< String table bytes between the header and the arena head */
+  uint8_t  capacity;      /**< Element capacity (header "n") */
+  uint8_t  element_count;
+  uint8_t  screen_count;
+  uint8_t  trigger_count;
+  uint8_t  preorder;
+  uint8_t  reserved[3];
+  uint32_t ui_hash;       /**< Hash of the JSON objects that built the UI */
+  uint32_t check;         /**< Hash of the header up to here and the arena bytes */
+} ui_persist_header_t;
+
+#define UI_PERSIST_HEADER_SIZE 28u
+#define UI_PERSIST_LAYOUT \
+  ((uint8_t) ((UI_ATTR_TEXT_INDEX ? 0x01u : 0x00u) | (UI_SCREEN_CACHE ? 0x02u : 0x00u) | \
+              (UI_SUBTREE_INDEX ? 0x04u : 0x00u)))
+
+#if UI_PERSIST && (UI_PERSIST_HEADER_SIZE + UI_ATTR_ARENA_CAP) > FLASH_STORE_SIZE
+#error "FLASH_STORE_SIZE is too small for the UI image"
+#endif
+
+typedef char ui_persist_header_size_check[(sizeof(ui_persist_header_t) == UI_PERSIST_HEADER_SIZE)
+                                            ? 1
+                                            : -1];
+
+static uint32_t g_ui_hash;  /* hash of the objects applied since HEAD (or of the restored UI) */
+static uint8_t  g_ui_flags; /* UI_IMAGE_FLAG_RESTORED */
+static uint16_t g_str_used; /* string table bytes the arena may reference */
+
+uint32_t ui_persist_hash(uint32_t hash, const uint8_t* data, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    hash ^= data[i];
+    /* hash *= 16777619 */
+    hash += (hash << 1) + (hash << 4) + (hash << 7) + (hash << 8) + (hash << 24);
+  }
+  return hash;
+}
+
+void ui_persist_note_object(const char* buf, uint8_t len, uint8_t flags)
+{
+  if (flags & JSON_FLAG_HEAD) {
+    g_ui_hash  = UI_PERSIST_HASH_INIT;
+    g_ui_flags = 0u;
+    g_str_used = 0u;
+  }
+  if (buf) {
+    g_ui_hash = ui_persist_hash(g_ui_hash, (const uint8_t*) buf, len);
+  }
+}
+
+#if UI_PERSIST
+
+/** Image hash: header up to the check field, then the string table and arena bytes. */
+static uint32_t ui_persist_check(const uint8_t* hdr, const uint8_t* str, uint16_t str_len,
+                                 const uint8_t* head, uint16_t head_len, const uint8_t* tail,
+                                 uint16_t tail_len)
+{
+  uint32_t h = ui_persist_hash(UI_PERSIST_HASH_INIT, hdr, offsetof(ui_persist_header_t, check));
+  h          = ui_persist_hash(h, str, str_len);
+  h          = ui_persist_hash(h, head, head_len);
+  return ui_persist_hash(h, tail, tail_len);
+}
+
+/** Copy out the stored header; non-zero when it belongs to this build and the hash matches. */
+static uint8_t ui_persist_stored(ui_persist_header_t* hdr)
+{
+  const uint8_t* img = flash_store_data();
+  memcpy(hdr, img, sizeof(*hdr));
+  if (hdr->magic[0] != 'U' || hdr->magic[1] != 'I' || hdr->version != UI_PERSIST_VERSION ||
+      hdr->layout != UI_PERSIST_LAYOUT || hdr->arena_cap != UI_ATTR_ARENA_CAP ||
+      hdr->capacity == 0u || hdr->element_count > hdr->capacity ||
+      (uint32_t) hdr->head_used + hdr->used_tail > UI_ATTR_ARENA_CAP ||
+      (uint32_t) UI_PERSIST_HEADER_SIZE + hdr->str_used + hdr->head_used + hdr->used_tail >
+        FLASH_STORE_SIZE) {
+    return 0u;
+  }
+  const uint8_t* str  = img + UI_PERSIST_HEADER_SIZE;
+  const uint8_t* head = str + hdr->str_used;
+  return (ui_persist_check(img, str, hdr->str_used, head, hdr->head_used,
+                           head + hdr->head_used, hdr->used_tail) == hdr->check)
+           ? 1u
+           : 0u;
+}
+
+/**
+ * Image byte at off: header, string table (stored part from flash, the rest from the static
+ * texts still in RAM), arena head, arena tail, then erased padding.
+ */
+static uint8_t ui_persist_image_byte(const ui_persist_header_t* hdr, uint16_t off)
+{
+  ui_runtime_t* rt = &g_protocol_state.runtime;
+  if (off < UI_PERSIST_HEADER_SIZE) {
+    return ((const uint8_t*) hdr)[off];
+  }
+  off = (uint16_t) (off - UI_PERSIST_HEADER_SIZE);
+  if (off < g_str_used) {
+    return flash_store_data()[UI_PERSIST_HEADER_SIZE + off];
+  }
+  if (off < hdr->str_used) {
+    return ui_attr_static_text_byte(rt, (uint16_t) (off - g_str_used));
+  }
+  off = (uint16_t) (off - hdr->str_used);
+  if (off < hdr->head_used) {
+    return rt->arena[off];
+  }
+  off = (uint16_t) (off - hdr->head_used);
+  if (off < hdr->used_tail) {
+    return rt->arena[UI_ATTR_ARENA_CAP - hdr->used_tail + off];
+  }
+  return 0xFFu;
+}
+
+/** Write the pages that overlap image bytes [from, to), last page first. */
+static int ui_persist_write(const ui_persist_header_t* hdr, uint16_t from, uint16_t to)
+{
+  if (from >= to) {
+    return RES_OK;
+  }
+  uint16_t first = (uint16_t) (from / FLASH_STORE_PAGE_SIZE);
+  uint16_t page  = (uint16_t) ((to + FLASH_STORE_PAGE_SIZE - 1u) / FLASH_STORE_PAGE_SIZE);
+  while (page-- > first) {
+    uint32_t words[FLASH_STORE_PAGE_SIZE / 4u];
+    uint16_t base = (uint16_t) (page * FLASH_STORE_PAGE_SIZE);
+    for (uint8_t i = 0; i < FLASH_STORE_PAGE_SIZE; i++) {
+      ((uint8_t*) words)[i] = ui_persist_image_byte(hdr, (uint16_t) (base + i));
+    }
+    int r = flash_store_write_page(base, words);
+    if (r != RES_OK) {
+      return r;
+    }
+  }
+  return RES_OK;
+}
+
+int ui_persist_save(void)
+{
+  protocol_state_t* st = &g_protocol_state;
+  ui_runtime_t*     rt = &st->runtime;
+  if (st->initialized == 0u) {
+    return RES_BAD_STATE;
+  }
+  ui_persist_header_t hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  uint16_t freed;
+  uint16_t add  = ui_attr_static_text_bytes(rt, &freed);
+  uint32_t size = (uint32_t) UI_PERSIST_HEADER_SIZE + g_str_used + rt->head_used + rt->used_tail;
+  if (size > FLASH_STORE_SIZE) {
+    return RES_NO_SPACE;
+  }
+  /* Static texts move to the string table when the image still fits; else they stay in RAM */
+  if (add != 0u && size + add <= (uint32_t) FLASH_STORE_SIZE + freed) {
+    /* Strings first (the header slot is blank until the final page goes out), then the
+       arena entries shrink to references */
+    hdr.str_used = (uint16_t) (g_str_used + add);
+    int r        = ui_persist_write(&hdr,
+                             (uint16_t) (UI_PERSIST_HEADER_SIZE + g_str_used),
+                             (uint16_t) (UI_PERSIST_HEADER_SIZE + hdr.str_used));
+    if (r != RES_OK) {
+      return r;
+    }
+    ui_attr_flash_static_texts(rt, g_str_used);
+    g_str_used = hdr.str_used;
+  }
+  hdr.magic[0]      = 'U';
+  hdr.magic[1]      = 'I';
+  hdr.version       = UI_PERSIST_VERSION;
+  hdr.layout        = UI_PERSIST_LAYOUT;
+  hdr.arena_cap     = UI_ATTR_ARENA_CAP;
+  hdr.head_used     = rt->head_used;
+  hdr.used_tail     = rt->used_tail;
+  hdr.str_used      = g_str_used;
+  hdr.capacity      = st->element_capacity;
+  hdr.element_count = st->element_count;
+  hdr.screen_count  = st->screen_count;
+  hdr.trigger_count = st->trigger_count;
+  hdr.preorder      = st->preorder;
+  hdr.ui_hash       = g_ui_hash;
+  hdr.check         = ui_persist_check((const uint8_t*) &hdr,
+                                       flash_store_data() + UI_PERSIST_HEADER_SIZE,
+                                       g_str_used,
+                                       rt->arena,
+                                       rt->head_used,
+                                       &rt->arena[UI_ATTR_ARENA_CAP - rt->used_tail],
+                                       rt->used_tail);
+  /* Pages holding only strings are already in place; the header page goes out last */
+  uint16_t body = (uint16_t) (UI_PERSIST_HEADER_SIZE + g_str_used);
+  uint16_t end  = (uint16_t) (body + rt->head_used + rt->used_tail);
+  int      r    = ui_persist_write(&hdr, (body > FLASH_STORE_PAGE_SIZE) ? body : FLASH_STORE_PAGE_SIZE, end);
+  if (r != RES_OK) {
+    return r;
+  }
+  return ui_persist_write(&hdr, 0u, UI_PERSIST_HEADER_SIZE);
+}
+
+int ui_persist_restore(void)
+{
+  ui_persist_header_t hdr;
+  if (ui_persist_stored(&hdr) == 0u) {
+    return RES_BAD_STATE;
+  }
+  protocol_state_t* st = &g_protocol_state;
+  ui_runtime_t*     rt = &st->runtime;
+  protocol_reset_state();
+  if (hdr.screen_count > UI_MAX_SCREENS || protocol_reserve_element_storage(hdr.capacity) != RES_OK ||
+      rt->head_used > hdr.head_used) {
+    protocol_reset_state();
+    return RES_BAD_STATE;
+  }
+  const uint8_t* body = flash_store_data() + UI_PERSIST_HEADER_SIZE + hdr.str_used;
+  memcpy(rt->arena, body, hdr.head_used);
+  memcpy(&rt->arena[UI_ATTR_ARENA_CAP - hdr.used_tail], body + hdr.head_used, hdr.used_tail);
+  rt->head_used     = hdr.head_used;
+  rt->used_tail     = hdr.used_tail;
+  st->element_count = hdr.element_count;
+  st->screen_count  = hdr.screen_count;
+  st->trigger_count = hdr.trigger_count;
+  st->preorder      = hdr.preorder;
+  st->header_seen   = 1u;
+  st->initialized   = 1u;
+  /* screen_ids lives outside the arena; rebuilding derives it from screen_ords */
+  element_rebuild_tables();
+  g_ui_hash         = hdr.ui_hash;
+  g_ui_flags        = UI_IMAGE_FLAG_RESTORED;
+  g_str_used        = hdr.str_used;
+  protocol_request_render();
+  return RES_OK;
+}
+
+uint8_t ui_persist_info(uint32_t* ui_hash)
+{
+  ui_persist_header_t hdr;
+  uint8_t             flags = g_ui_flags;
+  if (ui_persist_stored(&hdr) != 0u) {
+    flags |= UI_IMAGE_FLAG_STORED;
+  }
+  *ui_hash = (g_protocol_state.initialized != 0u) ? g_ui_hash : 0u;
+  return flags;
+}
+
+const char* ui_persist_string(uint16_t off)
+{
+  return (const char*) flash_store_data() + UI_PERSIST_HEADER_SIZE + off;
+}
+
+#else
+
+int ui_persist_save(void)
+{
+  return RES_BAD_STATE;
+}
+
+int ui_persist_restore(void)
+{
+  return RES_BAD_STATE;
+}
+
+uint8_t ui_persist_info(uint32_t* ui_hash)
+{
+  *ui_hash = (g_protocol_state.initialized != 0u) ? g_ui_hash : 0u;
+  return 0u;
+}
+
+#endif
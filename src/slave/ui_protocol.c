@@ -16,8 +16,12 @@
  * ========================================================================= */
 #include "ui_protocol.h"
 
+#include "ui_anim.h"
+#include "ui_edit.h"
 #include "ui_focus.h"
+#include "ui_layout.h"
 #include "ui_numeric.h"
+#include "ui_persist.h"
 #include "ui_tree.h"
 /* Always include hardware headers; native build substitutes stub versions via test/hal_stub. */
 #include "ch32fun.h"
@@ -154,6 +158,109 @@ void protocol_service_deferred_ops(void)
 /** Set a render request flag (the main loop starts rendering). */
 void protocol_request_render(void)
 {
+  ssd1306_invalidate_all();
+  g_render_requested = 1;
+}
+
+/** Panel rows [*top, *bottom] of a list's row window; *top holds the list y on entry. */
+static void protocol_list_window_rows(uint8_t list_id, int16_t* top, int16_t* bottom)
+{
+  ur_list_state_t* ls     = ur_list_find(&g_protocol_state.runtime, list_id);
+  uint8_t          window = (ls != NULL && ls->visible_rows != 0u) ? ls->visible_rows : 4u;
+  if (*top < 0) {
+    *top = 0;
+  }
+  *bottom = (int16_t) (*top + window * SSD1306_PAGE_HEIGHT - 1);
+}
+
+#if LIST_ANIM_START_LINE_SCROLL
+/** Damage panel rows [first, last] across the full width, clipped to the panel. */
+static void protocol_invalidate_rows(int16_t first, int16_t last)
+{
+  int16_t limit = (int16_t) ssd1306_height() - 1;
+  if (first < 0) {
+    first = 0;
+  }
+  if (last > limit) {
+    last = limit;
+  }
+  if (first > last) {
+    return;
+  }
+  ssd1306_invalidate_region((uint8_t) (first / SSD1306_PAGE_HEIGHT),
+                            (uint8_t) (last / SSD1306_PAGE_HEIGHT),
+                            0u,
+                            (uint8_t) (SSD1306_WIDTH - 1));
+}
+
+/**
+ * Scroll a list drawn alone on the panel by dy rows through the display start line.
+ * Besides the panel edge the driver exposes, only the rows entering the list window and
+ * the rows just outside it that received shifted list content are redrawn.
+ */
+void protocol_scroll_list_lines(uint8_t list_id, int8_t dy)
+{
+  int16_t x      = 0;
+  int16_t top    = 0;
+  int16_t bottom = 0;
+  if (ui_layout_compute_element(list_id, &x, &top) != RES_OK) {
+    protocol_request_render();
+    return;
+  }
+  protocol_list_window_rows(list_id, &top, &bottom);
+  ssd1306_scroll_lines(dy);
+  if (dy > 0) {
+    protocol_invalidate_rows((int16_t) (top - dy), (int16_t) (top - 1));
+    protocol_invalidate_rows((int16_t) (bottom - dy + 1), bottom);
+  } else {
+    protocol_invalidate_rows(top, (int16_t) (top - dy - 1));
+    protocol_invalidate_rows((int16_t) (bottom + 1), (int16_t) (bottom - dy));
+  }
+  g_render_requested = 1;
+}
+#endif
+
+/** Request a render limited to the panel area drawn by one element. */
+void protocol_request_render_element(uint8_t element_id)
+{
+  if (element_id >= g_protocol_state.element_count) {
+    return;
+  }
+  /* List rows and barrel options are drawn by their container */
+  uint8_t target = element_id;
+  uint8_t parent = g_protocol_state.elements[target].parent_id;
+  while (parent != INVALID_ELEMENT_ID &&
+         (g_protocol_state.elements[parent].type == ELEMENT_LIST_VIEW ||
+          g_protocol_state.elements[parent].type == ELEMENT_BARREL)) {
+    target = parent;
+    parent = g_protocol_state.elements[target].parent_id;
+  }
+  int16_t x = 0;
+  int16_t y = 0;
+  if (ui_layout_compute_element(target, &x, &y) != RES_OK) {
+    protocol_request_render();
+    return;
+  }
+  int16_t bottom = (int16_t) (y + SSD1306_PAGE_HEIGHT - 1);
+  if (g_protocol_state.elements[target].type == ELEMENT_LIST_VIEW) {
+    /* Same window as the renderer; include the cursor marker left of the rows */
+    protocol_list_window_rows(target, &y, &bottom);
+    x = (int16_t) (x - 6);
+  }
+  int16_t limit = (int16_t) ssd1306_height() - 1;
+  if (bottom < 0 || y > limit || x >= SSD1306_WIDTH) {
+    return; /* nothing visible changes */
+  }
+  if (y < 0) {
+    y = 0;
+  }
+  if (bottom > limit) {
+    bottom = limit;
+  }
+  ssd1306_invalidate_region((uint8_t) (y / SSD1306_PAGE_HEIGHT),
+                            (uint8_t) (bottom / SSD1306_PAGE_HEIGHT),
+                            (uint8_t) ((x < 0) ? 0 : x),
+                            (uint8_t) (SSD1306_WIDTH - 1));
   g_render_requested = 1;
 }
 
@@ -322,6 +429,9 @@ uint8_t protocol_element_capacity(void)
 
 /**
  * @brief Get overlay role for a screen element.
+ *
+ * A parentless SCREEN is either a base screen (it has an ordinal) or an overlay, so the role
+ * is read from the element tables instead of a stored attribute.
  * @param element_id Screen element id
  * @return overlay_role_t value (OVERLAY_NONE if not set or invalid)
  */
@@ -330,17 +440,12 @@ uint8_t protocol_screen_role(uint8_t element_id)
   if (element_id >= g_protocol_state.element_count) {
     return OVERLAY_NONE;
   }
-  if (g_protocol_state.elements == NULL) {
-    return OVERLAY_NONE;
-  }
-  if (g_protocol_state.elements[element_id].type != ELEMENT_SCREEN) {
-    return OVERLAY_NONE;
-  }
-  uint8_t role = OVERLAY_NONE;
-  if (ui_attr_get_screen_role(&g_protocol_state.runtime, element_id, &role) != RES_OK) {
+  const element_t* el = &g_protocol_state.elements[element_id];
+  if (el->type != ELEMENT_SCREEN || el->parent_id != INVALID_ELEMENT_ID) {
     return OVERLAY_NONE;
   }
-  return role;
+  return (g_protocol_state.screen_ords[element_id] == INVALID_ELEMENT_ID) ? OVERLAY_FULL
+                                                                          : OVERLAY_NONE;
 }
 
 int16_t protocol_numeric_value(uint8_t element_id)
@@ -395,7 +500,7 @@ static uint8_t map_type_key(const char* s)
 }
 
 /** Reserve per-element storage from the shared arena head. */
-static int protocol_reserve_element_storage(uint8_t capacity)
+int protocol_reserve_element_storage(uint8_t capacity)
 {
   if (capacity == 0u) {
     return RES_RANGE;
@@ -403,7 +508,17 @@ static int protocol_reserve_element_storage(uint8_t capacity)
   if (g_protocol_state.element_capacity != 0u) {
     return RES_BAD_STATE;
   }
-  uint16_t need = (uint16_t) capacity * (uint16_t) (sizeof(element_t) + 2u);
+  uint16_t need = (uint16_t) ((uint16_t) capacity * (uint16_t) (sizeof(element_t) + 6u) +
+                              (uint16_t) ((capacity + 7u) / 8u));
+#if UI_ATTR_TEXT_INDEX
+  need = (uint16_t) (need + (uint16_t) capacity * (uint16_t) sizeof(uint16_t));
+#endif
+#if UI_SCREEN_CACHE
+  need = (uint16_t) (need + (uint16_t) capacity * 2u);
+#endif
+#if UI_SUBTREE_INDEX
+  need = (uint16_t) (need + capacity);
+#endif
   if (need > (uint16_t) sizeof(g_protocol_state.runtime.arena)) {
     return RES_NO_SPACE;
   }
@@ -411,16 +526,57 @@ static int protocol_reserve_element_storage(uint8_t capacity)
   uint8_t* base = &g_protocol_state.runtime.arena[0];
   g_protocol_state.elements = (element_t*) &base[off];
   off = (uint16_t) (off + (uint16_t) capacity * (uint16_t) sizeof(element_t));
+#if UI_ATTR_TEXT_INDEX
+  /* Right after the 2-byte element entries, so the 16-bit table stays aligned */
+  g_protocol_state.text_attr_off = (uint16_t*) (void*) &base[off];
+  off = (uint16_t) (off + (uint16_t) capacity * (uint16_t) sizeof(uint16_t));
+#endif
   g_protocol_state.pos_x = &base[off];
   off = (uint16_t) (off + capacity);
   g_protocol_state.pos_y = &base[off];
   off = (uint16_t) (off + capacity);
+  g_protocol_state.first_child = &base[off];
+  off = (uint16_t) (off + capacity);
+  g_protocol_state.next_sibling = &base[off];
+  off = (uint16_t) (off + capacity);
+#if UI_SCREEN_CACHE
+  g_protocol_state.root_screen = &base[off];
+  off = (uint16_t) (off + capacity);
+  g_protocol_state.top_screen = &base[off];
+  off = (uint16_t) (off + capacity);
+#endif
+  g_protocol_state.screen_ords = &base[off];
+  off = (uint16_t) (off + capacity);
+#if UI_SUBTREE_INDEX
+  g_protocol_state.subtree_end = &base[off];
+  off = (uint16_t) (off + capacity);
+#endif
+  g_protocol_state.runtime_slot = &base[off];
+  off = (uint16_t) (off + capacity);
+  g_protocol_state.visible_bits = &base[off];
+  off = (uint16_t) (off + (capacity + 7u) / 8u);
   g_protocol_state.element_capacity = capacity;
   g_protocol_state.runtime.attr_base = off;
   g_protocol_state.runtime.head_used = off;
   memset(g_protocol_state.elements, 0xFF, (uint16_t) capacity * (uint16_t) sizeof(element_t));
+#if UI_ATTR_TEXT_INDEX
+  memset(g_protocol_state.text_attr_off, 0, (uint16_t) capacity * (uint16_t) sizeof(uint16_t));
+#endif
   memset(g_protocol_state.pos_x, 0, capacity);
   memset(g_protocol_state.pos_y, 0, capacity);
+  memset(g_protocol_state.first_child, INVALID_ELEMENT_ID, capacity);
+  memset(g_protocol_state.next_sibling, INVALID_ELEMENT_ID, capacity);
+#if UI_SCREEN_CACHE
+  memset(g_protocol_state.root_screen, INVALID_ELEMENT_ID, capacity);
+  memset(g_protocol_state.top_screen, INVALID_ELEMENT_ID, capacity);
+#endif
+  memset(g_protocol_state.screen_ords, INVALID_ELEMENT_ID, capacity);
+#if UI_SUBTREE_INDEX
+  memset(g_protocol_state.subtree_end, 0, capacity);
+#endif
+  memset(g_protocol_state.runtime_slot, 0, capacity);
+  g_protocol_state.preorder = 1u;
+  protocol_invalidate_visibility();
   return RES_OK;
 }
 
@@ -441,8 +597,8 @@ static uint8_t add_basic_element(uint8_t parent, uint8_t type, int x, int y)
   }
   uint8_t    id = g_protocol_state.element_count++;
   element_t* el = &g_protocol_state.elements[id];
-  el->parent_id = parent;
   el->type      = type;
+  element_set_parent(id, parent);
   ui_attr_store_position(&g_protocol_state.runtime, id, (uint8_t) x, (uint8_t) y, 8, LAYOUT_ABSOLUTE);
   return id;
 }
@@ -464,10 +620,13 @@ int handle_binary_command(uint8_t cmd, uint8_t* payload, uint8_t length)
       return cmd_scroll_to_screen(payload, length);
       /* List view update is host-side only now; no direct opcode dispatch. */
     case SPI_CMD_GET_ELEMENT_STATE: return cmd_get_element_state(payload, length);
+    case SPI_CMD_GET_PERF: return cmd_get_perf(payload, length);
   /* No error log feature */
   case SPI_CMD_SHOW_OVERLAY: return cmd_show_overlay(payload, length);
     case SPI_CMD_INPUT_EVENT: return cmd_input_event(payload, length);
     case SPI_CMD_GOTO_STANDBY: return cmd_goto_standby(payload, length);
+    case SPI_CMD_SAVE_UI: return cmd_save_ui(payload, length);
+    case SPI_CMD_GET_UI_IMAGE: return cmd_get_ui_image(payload, length);
     default: return RES_BAD_LEN;
   }
 }
@@ -490,6 +649,7 @@ int cmd_set_active_screen(uint8_t* p, uint8_t l)
   g_protocol_state.screen_anim.dir       = 0;
   g_protocol_state.screen_anim.from_screen = sid;
   g_protocol_state.screen_anim.to_screen   = sid;
+  protocol_invalidate_visibility();
   /* Screen change: auto-focus first focusable element on new screen */
   protocol_focus_first_on_screen(sid);
   debug_log_event(DEBUG_LED_EVT_SET_ACTIVE_SCREEN, (uint8_t) (sid & 0x07u));
@@ -527,6 +687,43 @@ int cmd_get_status(uint8_t* p, uint8_t l)
   g_protocol_state.status_dirty_id = INVALID_ELEMENT_ID;
   return PROTOCOL_RESP_SENT;
 }
+/** Store v little-endian at out[0..1]. */
+static void protocol_put_u16(uint8_t* out, uint16_t v)
+{
+  out[0] = (uint8_t) (v & 0xFFu);
+  out[1] = (uint8_t) (v >> 8);
+}
+int cmd_get_perf(uint8_t* p, uint8_t l)
+{
+  /* unused: p,l (GET_PERF carries no payload) */
+  ssd1306_perf_t perf;
+  int            r = ssd1306_perf_read(&perf);
+  if (r != RES_OK) {
+    return r;
+  }
+  uint16_t build_avg  = (perf.builds != 0u) ? (uint16_t) (perf.build_sum_us / perf.builds) : 0u;
+  uint16_t stream_avg = (perf.streams != 0u) ? (uint16_t) (perf.stream_sum_us / perf.streams) : 0u;
+  uint32_t fps_x10    = (perf.window_ms != 0u)
+                            ? ((uint32_t) perf.frames * 10000u) / perf.window_ms
+                            : 0u;
+  if (fps_x10 > 0xFFFFu) {
+    fps_x10 = 0xFFFFu;
+  }
+  /* RC + build min/max/avg + stream min/max/avg + fps*10 + frames + coalesced (u16 LE) */
+  uint8_t out[1 + 9 * 2];
+  out[0] = RC_OK;
+  protocol_put_u16(&out[1], perf.build_min_us);
+  protocol_put_u16(&out[3], perf.build_max_us);
+  protocol_put_u16(&out[5], build_avg);
+  protocol_put_u16(&out[7], perf.stream_min_us);
+  protocol_put_u16(&out[9], perf.stream_max_us);
+  protocol_put_u16(&out[11], stream_avg);
+  protocol_put_u16(&out[13], (uint16_t) fps_x10);
+  protocol_put_u16(&out[15], perf.frames);
+  protocol_put_u16(&out[17], perf.coalesced);
+  protocol_send_response(SPI_CMD_GET_PERF, out, (uint8_t) sizeof(out));
+  return PROTOCOL_RESP_SENT;
+}
 int cmd_scroll_to_screen(uint8_t* p, uint8_t l)
 {
   if (l == 1) {
@@ -542,6 +739,7 @@ int cmd_scroll_to_screen(uint8_t* p, uint8_t l)
     }
     g_protocol_state.active_screen = sid;
     g_protocol_state.scroll_x      = (int16_t) sid * 128;
+    protocol_invalidate_visibility();
     debug_log_event(DEBUG_LED_EVT_SCROLL_TO_SCREEN, (uint8_t) (sid & 0x07u));
     return RES_OK;
   }
@@ -565,6 +763,7 @@ int cmd_scroll_to_screen(uint8_t* p, uint8_t l)
 
     g_protocol_state.active_screen = sid;
     g_protocol_state.scroll_x      = off;
+    protocol_invalidate_visibility();
     debug_log_event(DEBUG_LED_EVT_SCROLL_TO_SCREEN, (uint8_t) (sid & 0x07u));
     return RES_OK;
   }
@@ -609,7 +808,7 @@ int cmd_show_overlay(uint8_t* p, uint8_t l)
   g_protocol_state.overlay.prev_focus               = g_protocol_state.focused_element;
   debug_log_event(DEBUG_LED_EVT_SHOW_OVERLAY, (uint8_t) (sid & 0x07u));
   protocol_clear_focus();
-  g_render_requested = 1;
+  protocol_request_render();
   return RES_OK;
 }
 
@@ -640,6 +839,38 @@ int cmd_goto_standby(uint8_t* p, uint8_t l)
   return PROTOCOL_RESP_SENT;
 }
 
+/** Store v little-endian at out[0..3]. */
+static void protocol_put_u32(uint8_t* out, uint32_t v)
+{
+  protocol_put_u16(out, (uint16_t) (v & 0xFFFFu));
+  protocol_put_u16(&out[2], (uint16_t) (v >> 16));
+}
+
+int cmd_save_ui(uint8_t* p, uint8_t l)
+{
+  /* unused: p (SAVE_UI has no payload) */
+  if (l != 0u) {
+    return RES_BAD_LEN;
+  }
+  int r = ui_persist_save();
+  if (r != RES_OK) {
+    return r;
+  }
+  return cmd_get_ui_image(p, l);
+}
+
+int cmd_get_ui_image(uint8_t* p, uint8_t l)
+{
+  /* unused: p,l (GET_UI_IMAGE carries no payload) */
+  uint32_t hash = 0u;
+  uint8_t  out[1 + 1 + 4]; /* RC + flags + UI hash (u32 LE) */
+  out[1] = ui_persist_info(&hash);
+  out[0] = RC_OK;
+  protocol_put_u32(&out[2], hash);
+  protocol_send_response(SPI_CMD_GET_UI_IMAGE, out, (uint8_t) sizeof(out));
+  return PROTOCOL_RESP_SENT;
+}
+
 
 /* Focus handling moved to ui_focus.c */
 
@@ -805,8 +1036,24 @@ void protocol_reset_state(void)
   g_protocol_state.element_count   = 0;
   g_protocol_state.element_capacity = 0;
   g_protocol_state.elements        = NULL;
+#if UI_ATTR_TEXT_INDEX
+  g_protocol_state.text_attr_off   = NULL;
+#endif
   g_protocol_state.pos_x           = NULL;
   g_protocol_state.pos_y           = NULL;
+  g_protocol_state.first_child     = NULL;
+  g_protocol_state.next_sibling    = NULL;
+#if UI_SCREEN_CACHE
+  g_protocol_state.root_screen     = NULL;
+  g_protocol_state.top_screen      = NULL;
+#endif
+  g_protocol_state.screen_ords     = NULL;
+#if UI_SUBTREE_INDEX
+  g_protocol_state.subtree_end     = NULL;
+#endif
+  g_protocol_state.visible_bits    = NULL;
+  g_protocol_state.runtime_slot    = NULL;
+  g_protocol_state.preorder        = 0u;
   g_protocol_state.scroll_x        = 0;
   g_protocol_state.initialized     = 0;
   g_protocol_state.status_dirty    = 0u;
@@ -834,6 +1081,7 @@ void protocol_reset_state(void)
     g_protocol_state.nav_stack[i].saved_active_screen = 0u;
   }
   memset(&g_protocol_state.screen_anim, 0, sizeof(g_protocol_state.screen_anim));
+  g_protocol_state.visible_valid = 0u;
   ur_init(&g_protocol_state.runtime);
 }
 void protocol_init(void)
@@ -868,84 +1116,24 @@ void protocol_tick_animations(void)
       uint8_t cleared_overlay = g_protocol_state.overlay.active_overlay_screen_id;
       g_protocol_state.overlay.active_overlay_screen_id = 0xFF;
       protocol_overlay_cleared();
-      g_render_requested = 1;
+      protocol_request_render();
       debug_log_event(DEBUG_LED_EVT_OVERLAY_CLEAR,
                       (cleared_overlay != 0xFFu) ? (uint8_t) (cleared_overlay & 0x07u)
                                                  : 0xFFu);
     }
   }
 
-  /* Frame throttle for animations. */
+  /* Animations are sampled from elapsed time, never stepped: when the panel is busy the
+     positions in between are dropped and the next frame start samples the current one. */
   if ((uint32_t) (now - last_anim_ms) < PROTOCOL_ANIM_FRAME_MS) {
     return; /* not time for next frame */
   }
-  last_anim_ms = now;
-
-  /* No scroll_x easing: horizontal motion handled by screen_anim blending only. */
-  /* Screen slide animation (logical active_screen already set to target).
-     We animate visual offset_px until reaching 128px; renderer will blend.
-   */
-  if (g_protocol_state.screen_anim.active) {
-    screen_anim_state_t* sa   = &g_protocol_state.screen_anim;
-    int16_t              step = SCREEN_ANIM_PIXELS_PER_FRAME;
-    if (step <= 0)
-      step = 1;
-    sa->offset_px = (int16_t) (sa->offset_px + step);
-    if (sa->offset_px >= 128) {
-      sa->active    = 0;
-      sa->offset_px = 0;
-      /* Snap base scroll to new active screen position */
-      g_protocol_state.scroll_x = (int16_t) g_protocol_state.active_screen * 128;
-      /* Re-assign focus now that the slide animation has finished */
-      protocol_focus_first_on_screen(g_protocol_state.active_screen);
-      protocol_request_render();
-    }
-  }
-  uint8_t any_anim = 0;
-  {
-    ur_off_t cur = g_protocol_state.runtime.lists_head_off;
-    while (cur) {
-      ur_list_node_t* n = (ur_list_node_t*) ur__ptr(&g_protocol_state.runtime, cur);
-      if (!n) break;
-      ur_list_state_t* ls = &n->st;
-      if (ls->anim_active) {
-        any_anim = 1;
-        if (ls->anim_pix < 8) {
-          uint8_t step = LIST_ANIM_PIXELS_PER_FRAME;
-          if (step == 0) step = 1;
-          uint8_t remain = (uint8_t) (8 - ls->anim_pix);
-          if (step > remain) step = remain;
-          ls->anim_pix = (uint8_t) (ls->anim_pix + step);
-          if (ls->anim_pix >= 8) {
-            ls->top_index   = ls->pending_top;
-            ls->cursor      = ls->pending_cursor;
-            ls->anim_active = 0;
-            ls->anim_dir    = 0;
-            ls->anim_pix    = 0;
-          }
-        }
-      }
-      cur = n->next_off;
-    }
-  }
-  if (any_anim || g_protocol_state.screen_anim.active) {
-    protocol_request_render();
-  }
-
-  if (g_protocol_state.edit_blink_active != 0u) {
-    uint8_t counter = g_protocol_state.edit_blink_counter;
-    counter = (uint8_t) (counter + 1u);
-    if (counter >= EDIT_BLINK_PERIOD_FRAMES) {
-      counter = 0u;
-      g_protocol_state.edit_blink_phase = (uint8_t) (g_protocol_state.edit_blink_phase ^ 1u);
-      protocol_request_render();
-    }
-    g_protocol_state.edit_blink_counter = counter;
-  } else {
-    g_protocol_state.edit_blink_counter = 0u;
-    g_protocol_state.edit_blink_phase   = 1u;
+  /* A start-line step must land on a settled panel: the last frame is the image it shifts */
+  if (ssd1306_render_async_busy() || g_render_requested) {
+    return;
   }
-
+  last_anim_ms = now;
+  ui_anim_sample((uint16_t) now);
 }
 
 /* SPI transport initialization has been moved to spi_slave_transport_init() in spi_slave_dma.c */
@@ -1004,6 +1192,7 @@ static int protocol_apply_json_object_internal(const char* buf, uint8_t len, uin
   if (flags & JSON_FLAG_HEAD) {
     protocol_reset_state();
   }
+  ui_persist_note_object(buf, len, flags);
   if (len > 0u && buf) {
     rc = parse_single_element_object(buf, len);
   }
@@ -1014,9 +1203,14 @@ static int protocol_apply_json_object_internal(const char* buf, uint8_t len, uin
       }
       return rc;
     }
-    /* Immediate render */
+    /* Immediate render; after the first commit, updates already recorded their damage */
+    if (g_protocol_state.initialized == 0u) {
+      list_build_row_tables();
+      protocol_request_render();
+    } else {
+      g_render_requested = 1;
+    }
     g_protocol_state.initialized = 1;
-    g_render_requested           = 1;
     debug_log_event(DEBUG_LED_EVT_JSON_COMMIT, 0u);
   }
   return rc;
@@ -1095,24 +1289,20 @@ static int handle_create_screen(const element_create_ctx_t* ctx)
     return err();
   }
   if (ctx->parent_id == INVALID_ELEMENT_ID) {
-    /* overlay role */
+    /* Overlay role: overlays get no ordinal, which is what protocol_screen_role() reads */
     int ov = 0;
-    if (extract_int_key(ctx->os, ctx->oe, "ov", &ov) == 0) {
-      if (ov < 0) {
-        ov = 0;
-      }
-      if (ov > 1) {
-        ov = 1;
-      }
-      if (ov != 0) {
-        (void) ui_attr_store_screen_role(&g_protocol_state.runtime, sid, (uint8_t) ov);
+    (void) extract_int_key(ctx->os, ctx->oe, "ov", &ov);
+    /* Count only base screens (overlay role NONE) and map their ordinals */
+    if (ov <= 0) {
+      if (g_protocol_state.screen_count >= UI_MAX_SCREENS) {
+        return RES_NO_SPACE;
       }
-    }
-    /* Count only base screens (overlay role NONE) */
-    if (ov == 0) {
+      g_protocol_state.screen_ids[g_protocol_state.screen_count] = sid;
+      g_protocol_state.screen_ords[sid] = g_protocol_state.screen_count;
       g_protocol_state.screen_count++;
       if (g_protocol_state.screen_count == 1) {
         g_protocol_state.active_screen = 0;
+        protocol_invalidate_visibility();
       }
     }
   }
@@ -1261,8 +1451,33 @@ static int handle_update_text(uint8_t id, const element_update_ctx_t* ctx)
     return 0;
   }
   char tb[21]; /* cap <= 20 + NUL */
-  if (extract_string_key(ctx->os, ctx->oe, "tx", tb, sizeof(tb)) == 0) {
-    (void) ui_attr_update_text(&g_protocol_state.runtime, id, tb);
+  int  has_text = (extract_string_key(ctx->os, ctx->oe, "tx", tb, sizeof(tb)) == 0);
+#if UI_STRUCT_EDIT
+  /* "c" reallocates the text with a new capacity (the entry moves to the end of the head) */
+  int cap = 0;
+  if (extract_int_key(ctx->os, ctx->oe, "c", &cap) == 0) {
+    if (cap < 0) cap = 0;
+    if (cap > 20) cap = 20;
+    if (!has_text) {
+      const char* cur = ui_attr_get_text(&g_protocol_state.runtime, id);
+      uint8_t     n   = 0u;
+      while (cur && cur[n] != '\0' && n < 20u) {
+        tb[n] = cur[n];
+        n++;
+      }
+      tb[n] = '\0';
+    }
+    int res = ui_attr_resize_text(&g_protocol_state.runtime, id, tb, (uint8_t) cap);
+    if (res == RES_OK) {
+      protocol_request_render_element(id);
+    }
+    return res;
+  }
+#endif
+  if (has_text) {
+    if (ui_attr_update_text(&g_protocol_state.runtime, id, tb) == RES_OK) {
+      protocol_request_render_element(id);
+    }
   }
   /* TEXT does not mark dirty on update */
   return 0;
@@ -1325,6 +1540,17 @@ static int handle_element_object(const char* os, const char* oe)
   if (g_protocol_state.element_capacity == 0u) {
     return RES_BAD_STATE;
   }
+#if UI_STRUCT_EDIT
+  /* {"t":"r","e":id} removes an element with its subtree; later ids shift down */
+  if (type_buf[0] == 'r' && type_buf[1] == '\0') {
+    int rid = -1;
+    if (extract_int_key(os, oe, "e", &rid) != 0 || rid < 0 ||
+        rid >= g_protocol_state.element_count) {
+      return RES_UNKNOWN_ID;
+    }
+    return ui_edit_remove_subtree((uint8_t) rid);
+  }
+#endif
   uint8_t tcode  = map_type_key(type_buf);
   int     parent = -1;
   extract_int_key(os, oe, "p", &parent);
@@ -1364,6 +1590,16 @@ static int handle_element_object(const char* os, const char* oe)
       .os        = os,
       .oe        = oe,
     };
+#if UI_STRUCT_EDIT
+    if (g_protocol_state.initialized != 0u) {
+      /* Post-COMMIT append: the new element joins its parent's id range */
+      uint8_t first = g_protocol_state.element_count;
+      uint8_t pre   = ui_edit_begin();
+      int     res   = handler->create(&cctx);
+      ui_edit_place_created(first, pre);
+      return res;
+    }
+#endif
     return handler->create(&cctx);
   }
   return 0;
@@ -22,17 +22,63 @@
 
 #include "element_types.h"
 #include "gfx_font.h"
+#include "gfx_raster.h"
 #include "gfx_shared.h"
 #include "ssd1306_driver.h"
+#include "ui_anim.h"
 #include "ui_runtime.h"
 #include "ui_layout.h"
 #include "ui_protocol.h"
+#include "ui_tree.h"
 #include "debug_led.h"
 
 #ifndef RENDER_MAX_DECIMALS
 #define RENDER_MAX_DECIMALS 2u
 #endif
 
+/*
+ * Drawable elements resolved per frame (8 bytes of static RAM each). A frame whose screen and
+ * overlay resolve more drawables than this is drawn without the display list: every page
+ * resolves the elements again, which costs more than the list saves. The default covers a
+ * screen of 8 drawables; raise it for denser screens when RAM allows. 0 disables the list.
+ */
+#ifndef UI_DISPLAY_LIST_CAP
+#define UI_DISPLAY_LIST_CAP 8u
+#endif
+
+/** Rows of SSD1306 GDDRAM; pages past the last row wrap to row 0 under the start line. */
+#define RENDER_GDDRAM_ROWS 64u
+
+/** Display-list entry flag: draw focus/selection highlight (list: cursor marker). */
+#define RENDER_DL_FLAG_HIGHLIGHT 0x01u
+
+/**
+ * @brief Element resolved once per frame (layout, text and page span).
+ */
+typedef struct {
+  int16_t x;       /**< Global x including scroll and slide offset */
+  int16_t y;       /**< Global y */
+  uint8_t id;      /**< Element id */
+  uint8_t text_id; /**< Element whose TEXT label is drawn (own or selected barrel option; 0xFF none) */
+  uint8_t pages;   /**< First page (high nibble) and last page (low nibble) touched */
+  uint8_t flags;   /**< RENDER_DL_FLAG_* */
+} render_dl_entry_t;
+
+/**
+ * @brief Per-frame display list built when the async frame starts.
+ */
+typedef struct {
+  uint8_t           overlay_sid;      /**< Overlay screen being drawn (0xFF = base screens) */
+  uint8_t           active_screen_id; /**< Element id of the active base screen */
+  uint8_t           count;            /**< Valid entries */
+  uint8_t           overflow;         /**< Non-zero when entries did not fit UI_DISPLAY_LIST_CAP */
+  uint8_t           row_min;          /**< First panel row the current page may draw */
+  uint8_t           row_max;          /**< Last panel row the current page may draw */
+  render_dl_entry_t entries[UI_DISPLAY_LIST_CAP];
+} render_display_list_t;
+
+static render_display_list_t g_display_list;
+
 /* Forward declarations */
 static void draw_masked_text(int16_t     x,
                              int16_t     pixel_y,
@@ -49,44 +95,6 @@ static void invert_row_region(uint8_t start_x,
 static uint8_t text_highlight_width(const char* text);
 static uint8_t edit_blink_visible(void);
 
-/**
-
-/* Helper: render only overlay children (TEXT only) for the given tile. */
-static void render_overlay_children_tile(uint8_t tile_y, uint8_t overlay_sid)
-{
-  if (overlay_sid == 0xFF) return;
-  if (overlay_sid >= g_protocol_state.element_count) return;
-  if (g_protocol_state.elements[overlay_sid].type != ELEMENT_SCREEN) return;
-
-  uint8_t page_top      = (uint8_t) (tile_y * SSD1306_PAGE_HEIGHT);
-  /* Keep overlay fixed on the display horizontally: ignore scroll_x and screen ordinals. */
-
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* elem = &g_protocol_state.elements[i];
-    /* Only TEXT is supported on overlay for size reasons */
-    if (elem->type != ELEMENT_TEXT) continue;
-    /* Resolve owning screen by climbing parents */
-    uint8_t parent = elem->parent_id;
-    while (parent != 0xFF && g_protocol_state.elements[parent].type != ELEMENT_SCREEN) {
-      parent = g_protocol_state.elements[parent].parent_id;
-    }
-    if (parent != overlay_sid) continue; /* not under overlay screen */
-
-    int16_t global_x = 0;
-    int16_t draw_y   = 0;
-    if (ui_layout_compute_element(i, &global_x, &draw_y) != 0) {
-      continue;
-    }
-    const char* txt = ui_attr_get_text(&g_protocol_state.runtime, i);
-    draw_masked_text(global_x,
-                     draw_y,
-                     txt,
-                     page_top,
-                     (uint8_t) (page_top + SSD1306_PAGE_HEIGHT - 1),
-                     page_top);
-  }
-}
-
 /**
  * @brief Return inclusive highlight width for a text string at base scale.
  *
@@ -136,416 +144,478 @@ static uint8_t edit_blink_visible(void)
   return g_protocol_state.edit_blink_phase;
 }
 
+/** Return the nearest SCREEN ancestor of an element (0xFF if none). */
+static uint8_t render_parent_screen(uint8_t eid)
+{
+  return element_root_screen(g_protocol_state.elements[eid].parent_id);
+}
+
+/** Clip a vertical pixel span to the panel and store its page range; 0 if off-panel. */
+static uint8_t render_set_page_span(render_dl_entry_t* entry, int16_t top, int16_t bottom)
+{
+  int16_t limit = (int16_t) ssd1306_height() - 1;
+  if (bottom < 0 || top > limit) {
+    return 0u;
+  }
+  if (top < 0) {
+    top = 0;
+  }
+  if (bottom > limit) {
+    bottom = limit;
+  }
+  entry->pages = (uint8_t) (((top / SSD1306_PAGE_HEIGHT) << 4) | (bottom / SSD1306_PAGE_HEIGHT));
+  return 1u;
+}
+
+/** Resolve overlay TEXT children into a display-list entry. */
+static uint8_t render_resolve_overlay(uint8_t eid, render_dl_entry_t* entry)
+{
+  /* Only TEXT is supported on overlay for size reasons */
+  if (g_protocol_state.elements[eid].type != ELEMENT_TEXT) {
+    return 0u;
+  }
+  if (render_parent_screen(eid) != g_display_list.overlay_sid) {
+    return 0u;
+  }
+  /* Keep overlay fixed on the display horizontally: layout ignores scroll_x for overlays. */
+  if (ui_layout_compute_element(eid, &entry->x, &entry->y) != 0) {
+    return 0u;
+  }
+  entry->id      = eid;
+  entry->text_id = eid;
+  entry->flags   = 0u;
+  return render_set_page_span(entry, entry->y, (int16_t) (entry->y + 7));
+}
+
+/** Resolve the selected option text and highlight state of a barrel. */
+static void render_resolve_barrel(uint8_t eid, uint8_t on_active, render_dl_entry_t* entry)
+{
+  int16_t selection = protocol_numeric_value(eid);
+  if (selection < 0) {
+    selection = 0;
+  }
+  uint8_t inline_list_selected = 0u;
+  uint8_t parent_text          = g_protocol_state.elements[eid].parent_id;
+  if (parent_text != INVALID_ELEMENT_ID &&
+      g_protocol_state.elements[parent_text].type == ELEMENT_TEXT) {
+    uint8_t list_parent = g_protocol_state.elements[parent_text].parent_id;
+    if (list_parent != INVALID_ELEMENT_ID &&
+        g_protocol_state.elements[list_parent].type == ELEMENT_LIST_VIEW) {
+      ur_list_state_t* ls_parent = ur_list_get_or_add(&g_protocol_state.runtime, list_parent);
+      if (ls_parent != NULL && list_parent == g_protocol_state.focused_element &&
+          ls_parent->anim_active == 0u && on_active != 0u) {
+        if (list_row_index_of_text(list_parent, parent_text) == ls_parent->cursor) {
+          inline_list_selected = 1u;
+        }
+      }
+    }
+  }
+  uint8_t child_ix = 0u;
+  for (uint8_t cid = element_next_child(eid, INVALID_ELEMENT_ID, ELEMENT_TEXT);
+       cid != INVALID_ELEMENT_ID;
+       cid = element_next_child(eid, cid, ELEMENT_TEXT)) {
+    if (child_ix == (uint8_t) selection) {
+      entry->text_id = cid;
+      break;
+    }
+    child_ix++;
+  }
+  uint8_t editing  = barrel_is_editing(eid);
+  uint8_t blink_on = (editing != 0u && g_protocol_state.edit_blink_active != 0u)
+                       ? edit_blink_visible()
+                       : 1u;
+  if (eid == g_protocol_state.focused_element && on_active != 0u) {
+    if (editing == 0u || blink_on != 0u) {
+      entry->flags = RENDER_DL_FLAG_HIGHLIGHT;
+    }
+  } else if (inline_list_selected != 0u) {
+    entry->flags = RENDER_DL_FLAG_HIGHLIGHT;
+  }
+}
+
 /**
- * @brief Scale an inclusive highlight width to account for text scaling.
- */
-/**
- * @brief Render the active screen via tile callback.
- *
- * Sets the active screen and triggers tile-based rendering.
- * Only works when the protocol system is initialized.
+ * @brief Resolve one element for the current frame.
  *
- * @param screen_id ID of the screen to render
+ * Applies visibility, ownership and layout once; the result carries everything the
+ * page callback needs. Returns 0 when the element draws nothing this frame.
  */
+static uint8_t render_resolve_element(uint8_t eid, render_dl_entry_t* entry)
+{
+  if (g_display_list.overlay_sid != INVALID_ELEMENT_ID) {
+    return render_resolve_overlay(eid, entry);
+  }
+  const element_t* elem = &g_protocol_state.elements[eid];
+  if (protocol_is_element_visible(eid) == 0u) {
+    return 0u;
+  }
+  /* Skip list children (handled in list branch) and barrel children (rendered by barrel) */
+  if (elem->parent_id != 0xFF) {
+    uint8_t parent_type = g_protocol_state.elements[elem->parent_id].type;
+    if (parent_type == ELEMENT_LIST_VIEW && elem->type == ELEMENT_TEXT) {
+      return 0u;
+    }
+    if (parent_type == ELEMENT_BARREL) {
+      return 0u;
+    }
+  }
+  if (elem->type != ELEMENT_TEXT && elem->type != ELEMENT_LIST_VIEW &&
+      elem->type != ELEMENT_BARREL) {
+    return 0u;
+  }
+  uint8_t owning_screen = element_top_screen(eid);
+  if (owning_screen == INVALID_ELEMENT_ID) {
+    return 0u;
+  }
+  if (find_screen_ordinal_by_id(owning_screen) == INVALID_ELEMENT_ID) {
+    return 0u; /* overlay screen, drawn by the overlay pass */
+  }
+  if (ui_layout_compute_element(eid, &entry->x, &entry->y) != 0) {
+    return 0u;
+  }
+  /* Symmetric culling window so content coming from left can be processed.
+    We still clip per-pixel in draw paths. */
+  if (entry->x < -143 || entry->x > 143) {
+    return 0u;
+  }
+  uint8_t on_active = (owning_screen == g_display_list.active_screen_id &&
+                       !g_protocol_state.screen_anim.active)
+                        ? 1u
+                        : 0u;
+  entry->id      = eid;
+  entry->text_id = INVALID_ELEMENT_ID;
+  entry->flags   = 0u;
+  if (elem->type == ELEMENT_TEXT) {
+    entry->text_id = eid;
+    if (eid == g_protocol_state.focused_element && on_active != 0u) {
+      entry->flags = RENDER_DL_FLAG_HIGHLIGHT;
+    }
+    return render_set_page_span(entry, entry->y, (int16_t) (entry->y + 7));
+  }
+  if (elem->type == ELEMENT_LIST_VIEW) {
+    ur_list_state_t* ls = ur_list_get_or_add(&g_protocol_state.runtime, eid);
+    if (!ls) {
+      return 0u;
+    }
+    if (on_active != 0u && g_protocol_state.focused_element == eid) {
+      entry->flags = RENDER_DL_FLAG_HIGHLIGHT;
+    }
+    int16_t base_y   = (entry->y < 0) ? 0 : entry->y;
+    uint8_t window   = ls->visible_rows ? ls->visible_rows : 4;
+    uint8_t max_rows = (ssd1306_height() >= 64u) ? 8u : 6u;
+    if (window > max_rows) {
+      window = max_rows;
+    }
+    return render_set_page_span(entry, base_y, (int16_t) (base_y + window * 8 - 1));
+  }
+  render_resolve_barrel(eid, on_active, entry);
+  return render_set_page_span(entry, entry->y, (int16_t) (entry->y + 7));
+}
+
 /**
- * @brief Tile callback for rendering visible elements.
+ * @brief Build the display list from the current animation state.
  *
- * This function is called by the SSD1306 driver for each tile (page).
- * It renders all visible elements that intersect with the current tile.
- *
- * @param tile_y Tile Y coordinate (0-3)
+ * Resolves the overlay/active screen and every drawable element once so each page callback
+ * only walks entries whose page span intersects it. Does not advance animations.
  */
-void render_screen_tile(uint8_t tile_y)
+void render_frame_resolve(void)
 {
+  render_display_list_t* dl = &g_display_list;
+  dl->count                 = 0u;
+  dl->overflow              = 0u;
+  dl->row_min               = 0u;
+  dl->row_max               = 0xFFu;
+
   /* Overlay state snapshot */
   uint8_t overlay_sid = g_protocol_state.overlay.active_overlay_screen_id;
-  uint8_t overlay_active = 0u;
   if (overlay_sid != 0xFF && overlay_sid < g_protocol_state.element_count &&
       g_protocol_state.elements[overlay_sid].type == ELEMENT_SCREEN &&
       protocol_screen_role(overlay_sid) == OVERLAY_FULL) {
-    overlay_active = 1u;
+    dl->overlay_sid = overlay_sid;
   } else {
-    overlay_sid = 0xFF;
-  }
-
-  if (overlay_active != 0u) {
-    render_overlay_children_tile(tile_y, overlay_sid);
-    return;
+    dl->overlay_sid = INVALID_ELEMENT_ID;
   }
 
   /* Resolve active screen element id (base screens only). */
-  uint8_t active_screen_id = INVALID_ELEMENT_ID;
-  {
-    uint8_t ord = 0u;
-    for (uint8_t j = 0; j < g_protocol_state.element_count; j++) {
-      if (g_protocol_state.elements[j].type == ELEMENT_SCREEN &&
-          g_protocol_state.elements[j].parent_id == INVALID_ELEMENT_ID &&
-          protocol_screen_role(j) == OVERLAY_NONE) {
-        if (ord == g_protocol_state.active_screen) {
-          active_screen_id = j;
-          break;
-        }
-        ord++;
-      }
-    }
-  }
+  dl->active_screen_id = find_screen_id_by_ordinal(g_protocol_state.active_screen);
 
+  /* A full list overflows only when one more element actually resolves */
+  render_dl_entry_t spare;
   for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    element_t* elem = &g_protocol_state.elements[i];
-    if (protocol_is_element_visible(i) == 0u) {
+    render_dl_entry_t* slot = (dl->count != UI_DISPLAY_LIST_CAP) ? &dl->entries[dl->count] : &spare;
+    if (render_resolve_element(i, slot) == 0u) {
       continue;
     }
-    /* Skip list children (handled in list branch) and barrel children (rendered by barrel) */
-    if (elem->parent_id != 0xFF) {
-      uint8_t parent_type = g_protocol_state.elements[elem->parent_id].type;
-      if (parent_type == ELEMENT_LIST_VIEW) {
-        if (elem->type == ELEMENT_TEXT) {
-          continue;
-        }
-      }
-      if (parent_type == ELEMENT_BARREL) {
-        /* Barrel renders its selected child label; suppress direct child draw */
-        continue;
-      }
+    if (slot == &spare) {
+      dl->overflow = 1u;
+      break;
     }
-    /* Resolve owning screen order */
-    uint8_t parent_screen = elem->parent_id;
-    while (parent_screen != 0xFF &&
-           g_protocol_state.elements[parent_screen].type != ELEMENT_SCREEN) {
-      parent_screen = g_protocol_state.elements[parent_screen].parent_id;
+    dl->count++;
+  }
+}
+
+/** Async frame-start hook: sample the animations, then build the display list. */
+void render_frame_begin(void)
+{
+  /* Animation state is sampled here so each frame shows the current wall-clock position */
+  ui_anim_frame_begin();
+  render_frame_resolve();
+}
+
+/** Draw the rows of a list entry that intersect the current page. */
+static void render_list_tile(const render_dl_entry_t* entry, uint8_t page_top)
+{
+  uint8_t          i  = entry->id;
+  ur_list_state_t* ls = ur_list_get_or_add(&g_protocol_state.runtime, i);
+  if (!ls) {
+    return;
+  }
+  int16_t base_global_x = entry->x; /* includes scroll and slide anim */
+  int16_t base_y        = entry->y;
+  if (base_y < 0) {
+    base_y = 0;
+  }
+  uint8_t window   = ls->visible_rows ? ls->visible_rows : 4;
+  uint8_t max_rows = (ssd1306_height() >= 64u) ? 8u : 6u;
+  if (window > max_rows) {
+    window = max_rows;
+  }
+  int8_t  dir             = ls->anim_active ? ls->anim_dir : 0;
+  uint8_t pix             = ls->anim_active ? ls->anim_pix : 0;
+  uint8_t top             = ls->top_index;
+  uint8_t viewport_top    = (uint8_t) base_y;
+  uint8_t viewport_bottom = (uint8_t) (base_y + window * 8 - 1);
+  uint8_t ic              = list_item_count(i);
+  uint8_t first = top;
+  if (dir == -1 && top > 0) first = (uint8_t) (top - 1);
+  uint8_t last = (uint8_t) (top + window - 1);
+  if (dir == +1 && (uint8_t) (top + window) < ic) last = (uint8_t) (top + window);
+  for (uint8_t r = first; r <= last && r < ic; r++) {
+    int16_t pixel_y;
+    if (dir == 0) {
+      pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8;
+    } else if (dir == +1) {
+      pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8 - pix;
+    } else { /* dir == -1 */
+      if (r == (uint8_t) (top - 1)) {
+        pixel_y = base_y - 8 + pix;
+      } else {
+        pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8 + pix;
+      }
     }
-    if (parent_screen == 0xFF) {
+    if ((pixel_y + 7) < viewport_top || pixel_y > viewport_bottom) {
       continue;
     }
-    uint8_t owning_screen = parent_screen;
-    if (owning_screen < g_protocol_state.element_count) {
-      uint8_t probe = owning_screen;
-      for (uint16_t depth = 0; depth < g_protocol_state.element_count; depth++) {
-        if (probe >= g_protocol_state.element_count) {
-          break;
-        }
-        uint8_t ps = g_protocol_state.elements[probe].parent_id;
-        if (ps == INVALID_ELEMENT_ID || ps >= g_protocol_state.element_count) {
-          break;
-        }
-        if (g_protocol_state.elements[ps].type == ELEMENT_SCREEN) {
-          owning_screen = ps;
-          probe         = ps;
-        } else {
-          probe = ps;
-        }
-      }
-    }
-    if (protocol_screen_role(owning_screen) != OVERLAY_NONE) {
+    if (pixel_y > (int16_t) (page_top + SSD1306_PAGE_HEIGHT - 1) || (pixel_y + 7) < page_top) {
       continue;
     }
-    int16_t global_x = 0;
-    int16_t global_y = 0;
-    if (ui_layout_compute_element(i, &global_x, &global_y) != 0) {
+    uint8_t item_eid = list_item_by_index(i, r);
+    if (item_eid == 0xFF) continue;
+    uint8_t ix = 0, iy_rel = 0, f2 = 0, lay2 = 0;
+    if (ui_attr_get_position(&g_protocol_state.runtime, item_eid, &ix, &iy_rel, &f2, &lay2) != 0) {
       continue;
     }
-    /* Symmetric culling window so content coming from left can be processed.
-      We still clip per-pixel in draw paths. */
-    if (global_x < -143 || global_x > 143) {
+    int16_t item_global_x = (int16_t) (base_global_x + ix);
+    if (item_global_x < -143 || item_global_x > 143) {
       continue;
     }
-    /* Keep signed x for masked/text rendering; clamp when API needs uint8. */
-    uint8_t draw_x = (global_x < 0) ? 0u : (uint8_t) global_x;
-    
-    /* For non-list elements, skip coarse tile filter and rely on fine-grained
-      checks inside draw paths (handles negative y during overlay slide). */
-
-    if (elem->type == ELEMENT_TEXT) {
-      const char* txt = ui_attr_get_text(&g_protocol_state.runtime, i);
-      /* Use masked text drawer to handle horizontal clipping (negative x).
-        Limit viewport to current tile to avoid uint8 wrap on negative y. */
-      uint8_t page_top = (uint8_t) (tile_y * SSD1306_PAGE_HEIGHT);
-      int16_t draw_y   = global_y;
-      draw_masked_text(global_x,
-                       draw_y,
-                       txt,
-                       page_top,
-                       (uint8_t) (page_top + SSD1306_PAGE_HEIGHT - 1),
-                       page_top);
-      if (i == g_protocol_state.focused_element &&
-          owning_screen == active_screen_id && !g_protocol_state.screen_anim.active) {
-        uint8_t page_top = (uint8_t) (tile_y * SSD1306_PAGE_HEIGHT);
-        uint8_t highlight_width = text_highlight_width(txt);
-        if (highlight_width < 18u) {
-          highlight_width = 18u;
-        }
-        invert_row_region(draw_x,
-                          highlight_width,
-                          (int16_t) global_y,
-                          (uint8_t) global_y,
-                          (uint8_t) (global_y + 7),
-                          page_top);
-      }
-    } else if (elem->type == ELEMENT_LIST_VIEW) {
-      {
-        ur_list_state_t* ls = ur_list_get_or_add(&g_protocol_state.runtime, i);
-        if (!ls) continue;
-        int16_t base_global_x = global_x; /* includes scroll and slide anim */
-        int16_t base_y        = global_y;
-        if (base_y < 0) {
-          base_y = 0;
-        }
-        uint8_t window        = ls->visible_rows ? ls->visible_rows : 4;
-        uint8_t max_rows      = (ssd1306_height() >= 64u) ? 8u : 6u;
-        if (window > max_rows) {
-          window = max_rows;
-        }
-        int8_t  dir             = ls->anim_active ? ls->anim_dir : 0;
-        uint8_t pix             = ls->anim_active ? ls->anim_pix : 0;
-        uint8_t top             = ls->top_index;
-        uint8_t viewport_top    = (uint8_t) base_y;
-        uint8_t viewport_bottom = (uint8_t) (base_y + window * 8 - 1);
-        uint8_t ic             = 0; /* recompute child count */
-        for (uint8_t e2 = 0; e2 < g_protocol_state.element_count; e2++) {
-          const element_t* child = &g_protocol_state.elements[e2];
-          if (child->parent_id == i && child->type == ELEMENT_TEXT) {
-            ic++;
-          }
-        }
-        uint8_t first = top;
-        if (dir == -1 && top > 0) first = (uint8_t) (top - 1);
-        uint8_t last = (uint8_t) (top + window - 1);
-        if (dir == +1 && (uint8_t) (top + window) < ic) last = (uint8_t) (top + window);
-        uint8_t page_top = (uint8_t) (tile_y * SSD1306_PAGE_HEIGHT);
-        for (uint8_t r = first; r <= last && r < ic; r++) {
-          int16_t pixel_y;
-          if (dir == 0) {
-            pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8;
-          } else if (dir == +1) {
-            pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8 - pix;
-          } else { /* dir == -1 */
-            if (r == (uint8_t) (top - 1)) {
-              pixel_y = base_y - 8 + pix;
-            } else {
-              pixel_y = base_y + ((int16_t) r - (int16_t) top) * 8 + pix;
-            }
-          }
-          if ((pixel_y + 7) < viewport_top || pixel_y > viewport_bottom) {
-            continue;
-          }
-          if (pixel_y > (int16_t) (page_top + SSD1306_PAGE_HEIGHT - 1) ||
-              (pixel_y + 7) < page_top) {
-            continue;
-          }
-          /* find r-th child eid */
-          uint8_t kk = 0;
-          uint8_t item_eid = 0xFF;
-          for (uint8_t e2 = 0; e2 < g_protocol_state.element_count; e2++) {
-            const element_t* child = &g_protocol_state.elements[e2];
-            if (child->parent_id != i) continue;
-            if (child->type != ELEMENT_TEXT) continue;
-            if (kk == r) { item_eid = e2; break; }
-            kk++;
-          }
-          if (item_eid == 0xFF) continue;
-          uint8_t ix = 0, iy_rel = 0, f2 = 0, lay2 = 0;
-          if (ui_attr_get_position(&g_protocol_state.runtime, item_eid, &ix, &iy_rel, &f2, &lay2) !=
-              0) {
-            continue;
-          }
-          int16_t item_global_x = (int16_t) (base_global_x + ix);
-          if (item_global_x < -143 || item_global_x > 143) {
-            continue;
-          }
-          /* signed X kept for masked draw */
-          element_t* item_el = &g_protocol_state.elements[item_eid];
-          if (item_el->type == ELEMENT_TEXT) {
-            const char* itxt = ui_attr_get_text(&g_protocol_state.runtime, item_eid);
-            draw_masked_text(item_global_x,
-                             pixel_y,
-                             itxt,
-                             viewport_top,
-                             viewport_bottom,
-                             page_top);
-          }
-          uint8_t highlight = 0;
-          if (!ls->anim_active) {
-            highlight = (r == ls->cursor);
-          } else {
-            highlight = (r == ls->cursor || r == ls->pending_cursor);
-          }
-          uint8_t list_has_focus = (g_protocol_state.focused_element == i) ? 1u : 0u;
-          if (highlight && owning_screen == active_screen_id &&
-              !g_protocol_state.screen_anim.active && list_has_focus) {
-            int16_t marker_gx = (int16_t) (item_global_x - 6);
-            draw_masked_text(marker_gx,
-                             pixel_y,
-                             ">",
-                             viewport_top,
-                             viewport_bottom,
-                             page_top);
-          }
-        }
-      }
-    } else if (elem->type == ELEMENT_BARREL) {
-      int16_t selection = protocol_numeric_value(i);
-      if (selection < 0) {
-        selection = 0;
-      }
-      uint8_t      page_top       = (uint8_t) (tile_y * SSD1306_PAGE_HEIGHT);
-      const char*  highlight_text = NULL;
-      char         label_buf[8];
-      uint8_t      child_ix       = 0u;
-      uint8_t      inline_list_selected = 0u;
-      uint8_t      parent_text          = g_protocol_state.elements[i].parent_id;
-      if (parent_text != INVALID_ELEMENT_ID &&
-          g_protocol_state.elements[parent_text].type == ELEMENT_TEXT) {
-        uint8_t list_parent = g_protocol_state.elements[parent_text].parent_id;
-        if (list_parent != INVALID_ELEMENT_ID &&
-            g_protocol_state.elements[list_parent].type == ELEMENT_LIST_VIEW) {
-          ur_list_state_t* ls_parent = ur_list_get_or_add(&g_protocol_state.runtime, list_parent);
-          if (ls_parent != NULL && list_parent == g_protocol_state.focused_element &&
-              ls_parent->anim_active == 0u && owning_screen == active_screen_id &&
-              !g_protocol_state.screen_anim.active) {
-            uint8_t row_index = 0u;
-            for (uint8_t scan = 0; scan < g_protocol_state.element_count; scan++) {
-              const element_t* candidate = &g_protocol_state.elements[scan];
-              if (candidate->parent_id != list_parent) {
-                continue;
-              }
-              if (candidate->type != ELEMENT_TEXT) {
-                continue;
-              }
-              if (scan == parent_text) {
-                break;
-              }
-              row_index++;
-            }
-            if (row_index == ls_parent->cursor) {
-              inline_list_selected = 1u;
-            }
-          }
-        }
-      }
-      for (uint8_t cid = 0; cid < g_protocol_state.element_count; cid++) {
-        const element_t* child = &g_protocol_state.elements[cid];
-        if (child->parent_id != i || child->type != ELEMENT_TEXT) {
-          continue;
-        }
-        if (child_ix == (uint8_t) selection) {
-          const char* txt = ui_attr_get_text(&g_protocol_state.runtime, cid);
-          if (txt != NULL) {
-            int16_t draw_y = global_y;
-            uint8_t y_u8 = (draw_y < 0) ? 0u : (uint8_t) draw_y;
-            draw_masked_text(global_x,
-                             draw_y,
-                             txt,
-                             y_u8,
-                             (uint8_t) (y_u8 + 7),
-                             page_top);
-            highlight_text = txt;
-          }
-          break;
-        }
-        child_ix++;
-      }
-      if (highlight_text == NULL) {
-        uint8_t y_off = (uint8_t) ((global_y < 0) ? 0 : (global_y % SSD1306_PAGE_HEIGHT));
-        int     len   = 0;
-        int     v     = (int) selection;
-        label_buf[len++] = '[';
-        if (v > 99) {
-          v %= 100;
-        }
-        if (v > 9) {
-          label_buf[len++] = (char) ('0' + (v / 10));
-          label_buf[len++] = (char) ('0' + (v % 10));
-        } else {
-          label_buf[len++] = (char) ('0' + v);
-        }
-        label_buf[len++] = ']';
-        label_buf[len]   = '\0';
-        ssd1306_tile_text(draw_x, y_off, label_buf);
-        highlight_text = label_buf;
-      }
-      uint8_t editing = barrel_is_editing(i);
-      uint8_t blink_on = (editing != 0u && g_protocol_state.edit_blink_active != 0u)
-                            ? edit_blink_visible()
-                            : 1u;
-      uint8_t should_invert = 0u;
-      if (i == g_protocol_state.focused_element && owning_screen == active_screen_id &&
-          !g_protocol_state.screen_anim.active) {
-        if (editing == 0u || blink_on != 0u) {
-          should_invert = 1u;
-        }
-      } else if (inline_list_selected != 0u) {
-        should_invert = 1u;
-      }
-      if (should_invert != 0u) {
-        const char* highlight_ref = (highlight_text != NULL) ? highlight_text : "";
-        uint8_t     highlight_width = text_highlight_width(highlight_ref);
-        int16_t draw_y = global_y;
-        uint8_t y_u8 = (draw_y < 0) ? 0u : (uint8_t) draw_y;
-        invert_row_region(draw_x,
-                          highlight_width,
-                          draw_y,
-                          y_u8,
-                          (uint8_t) (y_u8 + 7),
-                          page_top);
-      }
+    /* signed X kept for masked draw */
+    const char* itxt = ui_attr_get_text(&g_protocol_state.runtime, item_eid);
+    draw_masked_text(item_global_x, pixel_y, itxt, viewport_top, viewport_bottom, page_top);
+    uint8_t highlight = 0;
+    if (!ls->anim_active) {
+      highlight = (r == ls->cursor);
+    } else {
+      highlight = (r == ls->cursor || r == ls->pending_cursor);
+    }
+    if (highlight && (entry->flags & RENDER_DL_FLAG_HIGHLIGHT) != 0u) {
+      int16_t marker_gx = (int16_t) (item_global_x - 6);
+      draw_masked_text(marker_gx, pixel_y, ">", viewport_top, viewport_bottom, page_top);
     }
   }
 }
 
-/** Format a fixed-point number into a buffer with up to RENDER_MAX_DECIMALS. */
-/** Draw text within a vertical clip window and current tile page. */
-static __attribute__((unused)) void draw_masked_text(int16_t     x,
-                                                     int16_t     pixel_y,
-                                                     const char* text,
-                                                     uint8_t     viewport_top,
-                                                     uint8_t     viewport_bottom,
-                                                     uint8_t     page_top)
+/** Draw a barrel entry (selected option label or numeric fallback) into the page. */
+static void render_barrel_tile(const render_dl_entry_t* entry, uint8_t page_top)
 {
-  if (!text) {
+  const char* highlight_text = NULL;
+  char        label_buf[8];
+  uint8_t     draw_x = (entry->x < 0) ? 0u : (uint8_t) entry->x;
+  int16_t     draw_y = entry->y;
+  uint8_t     y_u8   = (draw_y < 0) ? 0u : (uint8_t) draw_y;
+  if (entry->text_id != INVALID_ELEMENT_ID) {
+    highlight_text = ui_attr_get_text(&g_protocol_state.runtime, entry->text_id);
+  }
+  if (highlight_text != NULL) {
+    draw_masked_text(entry->x, draw_y, highlight_text, y_u8, (uint8_t) (y_u8 + 7), page_top);
+  } else {
+    int16_t selection = protocol_numeric_value(entry->id);
+    if (selection < 0) {
+      selection = 0;
+    }
+    int     len   = 0;
+    int     v     = (int) selection;
+    label_buf[len++] = '[';
+    if (v > 99) {
+      v %= 100;
+    }
+    if (v > 9) {
+      label_buf[len++] = (char) ('0' + (v / 10));
+      label_buf[len++] = (char) ('0' + (v % 10));
+    } else {
+      label_buf[len++] = (char) ('0' + v);
+    }
+    label_buf[len++] = ']';
+    label_buf[len]   = '\0';
+    draw_masked_text(entry->x, draw_y, label_buf, y_u8, (uint8_t) (y_u8 + 7), page_top);
+    highlight_text = label_buf;
+  }
+  if ((entry->flags & RENDER_DL_FLAG_HIGHLIGHT) != 0u) {
+    uint8_t highlight_width = text_highlight_width(highlight_text);
+    invert_row_region(draw_x, highlight_width, draw_y, y_u8, (uint8_t) (y_u8 + 7), page_top);
+  }
+}
+
+/** Draw one resolved entry into the 8 rows starting at page_top. */
+static void render_entry_tile(const render_dl_entry_t* entry, uint8_t page_top)
+{
+  uint8_t first_row = (uint8_t) ((entry->pages >> 4) * SSD1306_PAGE_HEIGHT);
+  uint8_t last_row  = (uint8_t) ((entry->pages & 0x0Fu) * SSD1306_PAGE_HEIGHT + 7u);
+  if (page_top > last_row || (page_top + SSD1306_PAGE_HEIGHT - 1) < first_row) {
     return;
   }
-  if (pixel_y > viewport_bottom || (pixel_y + 7) < viewport_top) {
+  if (entry->id >= g_protocol_state.element_count) {
     return;
   }
-  if (pixel_y > (int16_t) (page_top + 7) || (pixel_y + 7) < page_top) {
+  uint8_t type     = g_protocol_state.elements[entry->id].type;
+  if (type == ELEMENT_LIST_VIEW) {
+    render_list_tile(entry, page_top);
+  } else if (type == ELEMENT_BARREL) {
+    render_barrel_tile(entry, page_top);
+  } else {
+    const char* txt = ui_attr_get_text(&g_protocol_state.runtime, entry->id);
+    /* Use masked text drawer to handle horizontal clipping (negative x).
+      Limit viewport to current tile to avoid uint8 wrap on negative y. */
+    draw_masked_text(entry->x,
+                     entry->y,
+                     txt,
+                     page_top,
+                     (uint8_t) (page_top + SSD1306_PAGE_HEIGHT - 1),
+                     page_top);
+    if ((entry->flags & RENDER_DL_FLAG_HIGHLIGHT) != 0u) {
+      uint8_t draw_x          = (entry->x < 0) ? 0u : (uint8_t) entry->x;
+      uint8_t highlight_width = text_highlight_width(txt);
+      if (highlight_width < 18u) {
+        highlight_width = 18u;
+      }
+      invert_row_region(draw_x,
+                        highlight_width,
+                        entry->y,
+                        (uint8_t) entry->y,
+                        (uint8_t) (entry->y + 7),
+                        page_top);
+    }
+  }
+}
+
+/**
+ * @brief Draw the 8 panel rows starting at row_top into the shared buffer.
+ *
+ * Walks the display-list entries whose page span intersects the rows. If the frame
+ * resolved more elements than UI_DISPLAY_LIST_CAP, elements are resolved again instead.
+ * row_top need not be page aligned.
+ */
+void render_screen_rows(uint8_t row_top)
+{
+  const render_display_list_t* dl = &g_display_list;
+  if (dl->overflow == 0u) {
+    for (uint8_t n = 0; n < dl->count; n++) {
+      render_entry_tile(&dl->entries[n], row_top);
+    }
     return;
   }
-  uint8_t* buf = gfx_get_shared_buffer();
-  int16_t  cx  = x;
-  while (*text && cx < (int16_t) SSD1306_WIDTH) {
-    uint8_t ch = (uint8_t) *text;
-    if (ch < GFX_FONT_FIRST_CHAR || ch > GFX_FONT_LAST_CHAR) {
-      ch = GFX_FONT_FIRST_CHAR;
+  render_dl_entry_t entry;
+  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+    if (render_resolve_element(i, &entry) != 0u) {
+      render_entry_tile(&entry, row_top);
     }
-    const uint8_t* glyph = GFX_FONT_DATA[ch - GFX_FONT_FIRST_CHAR];
-    for (uint8_t col = 0; col < GFX_FONT_CHAR_WIDTH && cx < (int16_t) SSD1306_WIDTH; col++) {
-      uint8_t col_bits = glyph[col];
-      if (col_bits) {
-        uint8_t out_bits = 0;
-        for (uint8_t b = 0; b < 8; b++) {
-          if (!(col_bits & (1u << b))) {
-            continue;
-          }
-          int16_t gy = pixel_y + b;
-          if (gy < viewport_top || gy > viewport_bottom) {
-            continue;
-          }
-          if (gy < page_top || gy > (int16_t) (page_top + 7)) {
-            continue;
-          }
-          out_bits |= (uint8_t) (1u << (gy - page_top));
-        }
-        if (cx >= 0) {
-          buf[(uint8_t) cx] |= out_bits;
-        }
-      }
-      cx++;
+  }
+}
+
+/**
+ * @brief Tile callback for rendering visible elements.
+ *
+ * This function is called by the SSD1306 driver for each GDDRAM page. The display
+ * start line maps the page back to panel rows; when those rows wrap past row 63 the
+ * page is drawn in two passes, each limited to its own rows.
+ *
+ * @param tile_y GDDRAM page (0-7)
+ */
+void render_screen_tile(uint8_t tile_y)
+{
+  render_display_list_t* dl  = &g_display_list;
+  uint8_t                top = (uint8_t) ((tile_y * SSD1306_PAGE_HEIGHT - ssd1306_frame_start_line()) &
+                                          (RENDER_GDDRAM_ROWS - 1u));
+  if (top <= RENDER_GDDRAM_ROWS - SSD1306_PAGE_HEIGHT) {
+    render_screen_rows(top);
+    return;
+  }
+  /* Rows top..63 fill the low bits, rows 0.. the bits above them */
+  uint8_t  split = (uint8_t) (RENDER_GDDRAM_ROWS - top);
+  uint8_t* buf   = gfx_get_shared_buffer();
+  dl->row_max    = (uint8_t) (SSD1306_PAGE_HEIGHT - 1u - split);
+  render_screen_rows(0u);
+  for (uint8_t c = 0; c < SSD1306_WIDTH; c++) {
+    buf[c] = (uint8_t) (buf[c] << split);
+  }
+  dl->row_min = top;
+  dl->row_max = (uint8_t) (RENDER_GDDRAM_ROWS - 1u);
+  render_screen_rows(top);
+  dl->row_min = 0u;
+  dl->row_max = 0xFFu;
+}
+
+/** Return 1 when the last frame drew nothing but list_id (no overlay, no other element). */
+uint8_t render_list_owns_panel(uint8_t list_id)
+{
+  const render_display_list_t* dl = &g_display_list;
+  if (dl->overlay_sid != INVALID_ELEMENT_ID) {
+    return 0u;
+  }
+  if (dl->overflow == 0u) {
+    return (dl->count == 1u && dl->entries[0].id == list_id) ? 1u : 0u;
+  }
+  /* Entries did not fit (always the case with UI_DISPLAY_LIST_CAP 0): resolve them again,
+     stopping at the first drawable that is not the list */
+  render_dl_entry_t entry;
+  uint8_t           owns = 0u;
+  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
+    if (render_resolve_element(i, &entry) == 0u) {
+      continue;
     }
-    if (cx < (int16_t) SSD1306_WIDTH) {
-      cx++;
+    if (i != list_id) {
+      return 0u;
     }
-    text++;
+    owns = 1u;
+  }
+  return owns;
+}
+
+/** Format a fixed-point number into a buffer with up to RENDER_MAX_DECIMALS. */
+/** Draw text within a vertical clip window and current tile page. */
+static void draw_masked_text(int16_t     x,
+                             int16_t     pixel_y,
+                             const char* text,
+                             uint8_t     viewport_top,
+                             uint8_t     viewport_bottom,
+                             uint8_t     page_top)
+{
+  if (viewport_top < g_display_list.row_min) {
+    viewport_top = g_display_list.row_min;
+  }
+  if (viewport_bottom > g_display_list.row_max) {
+    viewport_bottom = g_display_list.row_max;
   }
+  gfx_draw_text_clipped(x, pixel_y, text, viewport_top, viewport_bottom, page_top);
 }
 
 /** Invert a horizontal region within the current tile page. */
@@ -556,31 +626,27 @@ static void invert_row_region(uint8_t start_x,
                               uint8_t viewport_bottom,
                               uint8_t page_top)
 {
-  if (pixel_y > viewport_bottom || (pixel_y + 7) < viewport_top) {
-    return;
+  if (viewport_top < g_display_list.row_min) {
+    viewport_top = g_display_list.row_min;
   }
-  if (pixel_y > (int16_t) (page_top + 7) || (pixel_y + 7) < page_top) {
-    return;
+  if (viewport_bottom > g_display_list.row_max) {
+    viewport_bottom = g_display_list.row_max;
+  }
+  /* Rows of the text line that fall inside the viewport; width is inclusive */
+  int16_t top   = (pixel_y > viewport_top) ? pixel_y : (int16_t) viewport_top;
+  int16_t bottom = (int16_t) (pixel_y + 7);
+  if (bottom > viewport_bottom) {
+    bottom = viewport_bottom;
   }
-  if (start_x >= SSD1306_WIDTH) {
+  if (top > bottom || start_x >= SSD1306_WIDTH) {
     return;
   }
   if (start_x + width >= SSD1306_WIDTH) {
     width = (uint8_t) (SSD1306_WIDTH - 1 - start_x);
   }
-  uint8_t* buf = gfx_get_shared_buffer();
-  for (uint8_t cx = 0; cx <= width; cx++) {
-    uint8_t mask = 0;
-    for (uint8_t b = 0; b < 8; b++) {
-      int16_t gy = page_top + b;
-      if (gy < pixel_y || gy > pixel_y + 7) {
-        continue;
-      }
-      if (gy < viewport_top || gy > viewport_bottom) {
-        continue;
-      }
-      mask |= (uint8_t) (1u << b);
-    }
-    buf[start_x + cx] ^= mask;
-  }
+  gfx_invert_rect((int16_t) start_x,
+                  top,
+                  (uint8_t) (width + 1u),
+                  (uint8_t) (bottom - top + 1),
+                  page_top);
 }
@@ -5,6 +5,7 @@
 #include "ui_runtime.h"
 
 #include "status_codes.h"
+#include "ui_persist.h"
 #include "ui_protocol.h" /* for g_protocol_state */
 
 #include <string.h>
@@ -46,88 +47,149 @@ void* ur__alloc_tail(ui_runtime_t* rt, uint16_t size)
 	return (void*) (rt->arena + new_off);
 }
 
-ur_list_state_t* ur_list_find(ui_runtime_t* rt, uint8_t element_id)
+/** Runtime node kinds; the element type decides which one an element may own. */
+enum {
+	UR_KIND_LIST    = 0,
+	UR_KIND_TRIGGER = 1,
+	UR_KIND_BARREL  = 2,
+};
+
+static uint8_t ur_kind_of(uint8_t element_id)
+{
+	uint8_t type = g_protocol_state.elements[element_id].type;
+	if (type == ELEMENT_LIST_VIEW) return UR_KIND_LIST;
+	if (type == ELEMENT_TRIGGER) return UR_KIND_TRIGGER;
+	return UR_KIND_BARREL;
+}
+
+/** Resolve an element's runtime node through its slot (NULL if none or of another kind). */
+static void* ur_slot_find(ui_runtime_t* rt, uint8_t element_id, uint8_t kind)
 {
-	ur_off_t cur = rt->lists_head_off;
-	while (cur) {
-		ur_list_node_t* n = (ur_list_node_t*) ur__ptr(rt, cur);
-		if (!n) break;
-		if (n->st.element_id == element_id) return &n->st;
-		cur = n->next_off;
+	if (element_id >= g_protocol_state.element_count || ur_kind_of(element_id) != kind) {
+		return (void*) 0;
 	}
-	return (ur_list_state_t*) 0;
+	uint8_t slot = g_protocol_state.runtime_slot[element_id];
+	if (slot == 0u) return (void*) 0;
+	return (void*) (rt->arena + (UI_ATTR_ARENA_CAP - (uint16_t) slot * UR_SLOT_UNIT));
+}
+
+/** Allocate a zeroed runtime node on a slot boundary and record its slot. */
+static void* ur_slot_add(ui_runtime_t* rt, uint8_t element_id, uint8_t kind, uint16_t size)
+{
+	if (element_id >= g_protocol_state.element_count || ur_kind_of(element_id) != kind) {
+		return (void*) 0;
+	}
+	/* Round the tail (row tables are only 2-byte aligned) and the node up to whole units */
+	uint16_t pad  = (uint16_t) ((UR_SLOT_UNIT - rt->used_tail % UR_SLOT_UNIT) % UR_SLOT_UNIT);
+	uint16_t need = (uint16_t) (pad + (size + UR_SLOT_UNIT - 1u) / UR_SLOT_UNIT * UR_SLOT_UNIT);
+	uint8_t* n    = (uint8_t*) ur__alloc_tail(rt, need);
+	if (!n) return (void*) 0;
+	memset(n, 0, need);
+	g_protocol_state.runtime_slot[element_id] = (uint8_t) (rt->used_tail / UR_SLOT_UNIT);
+	return (void*) n;
+}
+
+/** Slot-rounded size of the runtime node an element of this kind owns. */
+static uint16_t ur_node_size(uint8_t kind)
+{
+	uint16_t size = (kind == UR_KIND_LIST)      ? (uint16_t) sizeof(ur_list_state_t)
+	                : (kind == UR_KIND_TRIGGER) ? (uint16_t) sizeof(ur_trigger_state_t)
+	                                            : (uint16_t) sizeof(ur_barrel_state_t);
+	return (uint16_t) ((size + UR_SLOT_UNIT - 1u) / UR_SLOT_UNIT * UR_SLOT_UNIT);
+}
+
+uint8_t ur_remap_id(const ur_remap_t* m, uint8_t element_id)
+{
+	if (element_id == UR_INVALID_ELEMENT_ID) return element_id;
+	if (m->op == UR_REMAP_REMOVE) {
+		if (element_id < m->a) return element_id;
+		if (element_id < m->b) return UR_INVALID_ELEMENT_ID;
+		return (uint8_t) (element_id - (m->b - m->a));
+	}
+	if (m->op == UR_REMAP_MOVE && element_id >= m->a && element_id <= m->b) {
+		return (element_id == m->b) ? m->a : (uint8_t) (element_id + 1u);
+	}
+	return element_id;
+}
+
+void ur_compact(ui_runtime_t* rt)
+{
+	uint8_t  count = g_protocol_state.element_count;
+	uint8_t* slots = g_protocol_state.runtime_slot;
+	for (uint8_t i = 0; i < count; i++) {
+		ur_list_state_t* ls = ur_list_find(rt, i);
+		if (ls) {
+			ls->rows_off  = 0u;
+			ls->row_count = 0u;
+		}
+	}
+	/* Move nodes nearest the end first: a node only moves towards the end, over gaps and
+	   nodes already moved, never over one still waiting */
+	uint16_t tail = 0u;
+	uint8_t  prev = 0u;
+	for (;;) {
+		uint8_t eid = UR_INVALID_ELEMENT_ID;
+		for (uint8_t i = 0; i < count; i++) {
+			if (slots[i] > prev && (eid == UR_INVALID_ELEMENT_ID || slots[i] < slots[eid])) eid = i;
+		}
+		if (eid == UR_INVALID_ELEMENT_ID) break;
+		prev = slots[eid];
+		uint16_t size = ur_node_size(ur_kind_of(eid));
+		tail          = (uint16_t) (tail + size);
+		uint8_t* dst  = rt->arena + (UI_ATTR_ARENA_CAP - tail);
+		memmove(dst, rt->arena + (UI_ATTR_ARENA_CAP - (uint16_t) prev * UR_SLOT_UNIT), size);
+		dst[0]     = eid; /* element_id leads every node */
+		slots[eid] = (uint8_t) (tail / UR_SLOT_UNIT);
+	}
+	rt->used_tail = tail;
+}
+
+ur_list_state_t* ur_list_find(ui_runtime_t* rt, uint8_t element_id)
+{
+	return (ur_list_state_t*) ur_slot_find(rt, element_id, UR_KIND_LIST);
 }
 
 ur_list_state_t* ur_list_get_or_add(ui_runtime_t* rt, uint8_t element_id)
 {
 	ur_list_state_t* s = ur_list_find(rt, element_id);
 	if (s) return s;
-	ur_list_node_t* n = (ur_list_node_t*) ur__alloc_tail(rt, (uint16_t) sizeof(ur_list_node_t));
-	if (!n) return 0;
-	n->next_off            = rt->lists_head_off;
-	n->st.element_id       = element_id;
-	n->st.cursor           = 0;
-	n->st.top_index        = 0;
-	n->st.visible_rows     = 4;
-	n->st.anim_active      = 0;
-	n->st.anim_dir         = 0;
-	n->st.anim_pix         = 0;
-	n->st.pending_top      = 0;
-	n->st.pending_cursor   = 0;
-	n->st.last_text_child  = UR_INVALID_ELEMENT_ID;
-	rt->lists_head_off     = ur__off(rt, n);
-	return &n->st;
+	s = (ur_list_state_t*) ur_slot_add(rt, element_id, UR_KIND_LIST, (uint16_t) sizeof(ur_list_state_t));
+	if (!s) return 0;
+	s->element_id      = element_id;
+	s->visible_rows    = 4;
+	s->last_text_child = UR_INVALID_ELEMENT_ID;
+	return s;
 }
 
 ur_trigger_state_t* ur_trigger_find(ui_runtime_t* rt, uint8_t element_id)
 {
-	ur_off_t cur = rt->triggers_head_off;
-	while (cur) {
-		ur_trigger_node_t* n = (ur_trigger_node_t*) ur__ptr(rt, cur);
-		if (!n) break;
-		if (n->st.element_id == element_id) return &n->st;
-		cur = n->next_off;
-	}
-	return (ur_trigger_state_t*) 0;
+	return (ur_trigger_state_t*) ur_slot_find(rt, element_id, UR_KIND_TRIGGER);
 }
 
 ur_trigger_state_t* ur_trigger_get_or_add(ui_runtime_t* rt, uint8_t element_id)
 {
 	ur_trigger_state_t* found = ur_trigger_find(rt, element_id);
 	if (found) return found;
-	ur_trigger_node_t* n = (ur_trigger_node_t*) ur__alloc_tail(rt, (uint16_t) sizeof(ur_trigger_node_t));
-	if (!n) return (ur_trigger_state_t*) 0;
-	n->next_off           = rt->triggers_head_off;
-	n->st.element_id      = element_id;
-	n->st.version         = 0;
-	rt->triggers_head_off = ur__off(rt, n);
-	return &n->st;
+	found = (ur_trigger_state_t*) ur_slot_add(rt, element_id, UR_KIND_TRIGGER,
+	                                          (uint16_t) sizeof(ur_trigger_state_t));
+	if (!found) return (ur_trigger_state_t*) 0;
+	found->element_id = element_id;
+	return found;
 }
 
 ur_barrel_state_t* ur_barrel_find(ui_runtime_t* rt, uint8_t element_id)
 {
-	ur_off_t cur = rt->barrels_head_off;
-	while (cur) {
-		ur_barrel_node_t* n = (ur_barrel_node_t*) ur__ptr(rt, cur);
-		if (!n) break;
-		if (n->st.element_id == element_id) return &n->st;
-		cur = n->next_off;
-	}
-	return (ur_barrel_state_t*) 0;
+	return (ur_barrel_state_t*) ur_slot_find(rt, element_id, UR_KIND_BARREL);
 }
 
 ur_barrel_state_t* ur_barrel_get_or_add(ui_runtime_t* rt, uint8_t element_id)
 {
 	ur_barrel_state_t* s = ur_barrel_find(rt, element_id);
 	if (s) return s;
-	ur_barrel_node_t* n = (ur_barrel_node_t*) ur__alloc_tail(rt, (uint16_t) sizeof(ur_barrel_node_t));
-	if (!n) return (ur_barrel_state_t*) 0;
-	n->next_off       = rt->barrels_head_off;
-	n->st.element_id  = element_id;
-	n->st.aux         = 0;
-	n->st.value       = 0;
-	rt->barrels_head_off = ur__off(rt, n);
-	return &n->st;
+	s = (ur_barrel_state_t*) ur_slot_add(rt, element_id, UR_KIND_BARREL, (uint16_t) sizeof(ur_barrel_state_t));
+	if (!s) return (ur_barrel_state_t*) 0;
+	s->element_id = element_id;
+	return s;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -147,10 +209,10 @@ static uint16_t ui_attr_skip_entry(const uint8_t* p)
 	uint8_t tag = p[0];
 	switch (tag) {
 		case UI_ATTR_TAG_TEXT: {
-			uint8_t size = p[2];
+			uint8_t size = (uint8_t)(p[2] & UI_ATTR_TEXT_SIZE_MASK);
 			return (uint16_t)(UI_ATTR_SIZE_TEXT_HDR + size); /* tag,element_id,len,data (includes NUL space) */
 		}
-		case UI_ATTR_TAG_SCREEN_ROLE: return UI_ATTR_SIZE_SCREEN_ROLE;
+		case UI_ATTR_TAG_TEXT_FLASH: return UI_ATTR_SIZE_TEXT_FLASH;
 		default: return 0u; /* Corrupt */
 	}
 }
@@ -162,11 +224,17 @@ static uint8_t* ui_attr_find(ui_runtime_t* rt, uint8_t element_id, uint8_t tag)
 		return 0;
 	}
 	if (element_id >= g_protocol_state.element_capacity) return 0;
+#if UI_ATTR_TEXT_INDEX
+	if (tag == UI_ATTR_TAG_TEXT) {
+		uint16_t toff = g_protocol_state.text_attr_off[element_id];
+		return toff ? &rt->arena[toff] : 0;
+	}
+#endif
 	uint16_t off = rt->attr_base;
 	uint8_t* base = &rt->arena[0];
 	while (off < rt->head_used) {
 		uint8_t* e = &base[off];
-		if (e[0] == tag && e[1] == element_id) {
+		if ((e[0] == tag || (tag == UI_ATTR_TAG_TEXT && UI_ATTR_IS_TEXT(e[0]))) && e[1] == element_id) {
 			return e;
 		}
 		uint16_t adv = ui_attr_skip_entry(e);
@@ -176,6 +244,52 @@ static uint8_t* ui_attr_find(ui_runtime_t* rt, uint8_t element_id, uint8_t tag)
 	return 0;
 }
 
+#if UI_ATTR_TEXT_INDEX
+/** Rebuild the text offset table after entries moved inside the head. */
+static void ui_attr_reindex(ui_runtime_t* rt)
+{
+	memset(g_protocol_state.text_attr_off, 0,
+	       (uint16_t) g_protocol_state.element_capacity * (uint16_t) sizeof(uint16_t));
+	uint16_t off = rt->attr_base;
+	while (off < rt->head_used) {
+		uint8_t* e   = &rt->arena[off];
+		uint16_t adv = ui_attr_skip_entry(e);
+		if (adv == 0u) break;
+		if (UI_ATTR_IS_TEXT(e[0])) {
+			g_protocol_state.text_attr_off[e[1]] = off;
+		}
+		off = (uint16_t) (off + adv);
+	}
+}
+#else
+#define ui_attr_reindex(rt) ((void) (rt))
+#endif
+
+/** Close up one entry of adv bytes at off (later entries move down). */
+static void ui_attr_drop(ui_runtime_t* rt, uint16_t off, uint16_t adv)
+{
+	memmove(&rt->arena[off], &rt->arena[off + adv], (uint16_t) (rt->head_used - off - adv));
+	rt->head_used = (uint16_t) (rt->head_used - adv);
+}
+
+void ui_attr_remap(ui_runtime_t* rt, const ur_remap_t* m)
+{
+	uint16_t off = rt->attr_base;
+	while (off < rt->head_used) {
+		uint8_t* e   = &rt->arena[off];
+		uint16_t adv = ui_attr_skip_entry(e);
+		if (adv == 0u) break;
+		uint8_t id = ur_remap_id(m, e[1]);
+		if (id == UR_INVALID_ELEMENT_ID) {
+			ui_attr_drop(rt, off, adv);
+			continue;
+		}
+		e[1] = id;
+		off  = (uint16_t) (off + adv);
+	}
+	ui_attr_reindex(rt);
+}
+
 /** Append a new attribute entry to the arena during provisioning. */
 static int ui_attr_append(ui_runtime_t* rt,
                           uint8_t       element_id,
@@ -184,10 +298,12 @@ static int ui_attr_append(ui_runtime_t* rt,
                           uint8_t       len_prefix,
                           uint16_t      payload_len)
 {
+#if !UI_STRUCT_EDIT
 	/* Appends are only allowed during JSON init/build phase (before COMMIT). */
 	if (g_protocol_state.initialized) {
 		return RES_BAD_STATE;
 	}
+#endif
 	if (element_id >= g_protocol_state.element_capacity) {
 		return RES_RANGE;
 	}
@@ -205,6 +321,11 @@ static int ui_attr_append(ui_runtime_t* rt,
 	uint16_t pos = 2u;
 	if (len_prefix) { e[2] = (uint8_t)payload_len; pos = 3u; }
 	if (payload_len && payload) { memcpy(&e[pos], payload, payload_len); }
+#if UI_ATTR_TEXT_INDEX
+	if (tag == UI_ATTR_TAG_TEXT) {
+		g_protocol_state.text_attr_off[element_id] = rt->head_used;
+	}
+#endif
 	rt->head_used = (uint16_t)(rt->head_used + need);
 	return RES_OK;
 }
@@ -216,16 +337,8 @@ int ui_attr_store_text_with_cap(ui_runtime_t* rt,
 {
 	uint8_t len = 0u;
 	if (text) { while (text[len]) len++; }
-	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT);
-	if (e) {
-		ui_attr_text_entry_t* t = (ui_attr_text_entry_t*)e;
-		uint8_t size = t->len; /* store field now encodes allocated payload size incl NUL */
-		if (size == 0u) return RES_NO_SPACE;
-		/* Write up to size-1 and NUL-terminate */
-		uint8_t w = (len < (uint8_t)(size - 1u)) ? len : (uint8_t)(size - 1u);
-		if (w) memcpy(t->data, text, w);
-		t->data[w] = '\0';
-		return RES_OK;
+	if (ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT)) {
+		return ui_attr_update_text(rt, element_id, text);
 	}
 	/* Determine capacity: if zero, use len; protocol clamps to <=20 when provided */
 	uint8_t cap = capacity ? capacity : len;
@@ -235,6 +348,7 @@ int ui_attr_store_text_with_cap(ui_runtime_t* rt,
 	uint8_t* e2 = ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT);
 	if (!e2) return RES_UNKNOWN_ID;
 	ui_attr_text_entry_t* t = (ui_attr_text_entry_t*)e2;
+	if (capacity == 0u) t->len |= UI_ATTR_TEXT_STATIC;
 	uint8_t w = (len < cap) ? len : cap;
 	if (w && text) memcpy(t->data, text, w);
 	t->data[w] = '\0';
@@ -250,16 +364,54 @@ const char* ui_attr_get_text(ui_runtime_t* rt, uint8_t element_id)
 {
 	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT);
 	if (!e) return 0;
+#if UI_PERSIST
+	if (e[0] == UI_ATTR_TAG_TEXT_FLASH) {
+		return ui_persist_string((uint16_t)(e[3] | ((uint16_t)e[4] << 8)));
+	}
+#endif
 	ui_attr_text_entry_t* t = (ui_attr_text_entry_t*)e;
 	return (const char*)t->data; /* points to first char */
 }
 
+#if UI_PERSIST
+/**
+ * Turn a flash reference back into a RAM entry of its original size (the gap opens in place,
+ * later entries move up) that is no longer static. Returns the entry, or 0 when the arena has
+ * no room for it.
+ */
+static uint8_t* ui_attr_unflash(ui_runtime_t* rt, uint8_t* e)
+{
+	uint16_t off  = (uint16_t)(e - rt->arena);
+	uint16_t size = (uint16_t)(e[2] & UI_ATTR_TEXT_SIZE_MASK);
+	uint16_t grow = (uint16_t)(UI_ATTR_SIZE_TEXT_HDR + size - UI_ATTR_SIZE_TEXT_FLASH);
+	if ((uint32_t) rt->head_used + grow + rt->used_tail > (uint32_t) UI_ATTR_ARENA_CAP) {
+		return 0;
+	}
+	uint16_t end = (uint16_t)(off + UI_ATTR_SIZE_TEXT_FLASH);
+	memmove(&rt->arena[end + grow], &rt->arena[end], (uint16_t)(rt->head_used - end));
+	rt->head_used = (uint16_t)(rt->head_used + grow);
+	e[0] = UI_ATTR_TAG_TEXT;
+	/* The label now changes at runtime: later saves keep it in RAM */
+	e[2] = (uint8_t)(e[2] & UI_ATTR_TEXT_SIZE_MASK);
+	ui_attr_reindex(rt);
+	return e;
+}
+#endif
+
 int ui_attr_update_text(ui_runtime_t* rt, uint8_t element_id, const char* new_text)
 {
 	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT);
 	if (!e) return RES_UNKNOWN_ID;
+#if UI_PERSIST
+	if (e[0] == UI_ATTR_TAG_TEXT_FLASH) {
+		/* Same text: keep it in flash; otherwise it needs its RAM entry back */
+		if (strcmp(ui_attr_get_text(rt, element_id), new_text ? new_text : "") == 0) return RES_OK;
+		e = ui_attr_unflash(rt, e);
+		if (!e) return RES_NO_SPACE;
+	}
+#endif
 	ui_attr_text_entry_t* t = (ui_attr_text_entry_t*)e;
-	uint8_t size = t->len; /* allocated payload size including NUL */
+	uint8_t size = (uint8_t)(t->len & UI_ATTR_TEXT_SIZE_MASK); /* allocated payload size including NUL */
 	uint8_t nlen = 0u;
 	if (new_text) while (new_text[nlen]) nlen++;
 	if (size == 0u) return RES_NO_SPACE;
@@ -269,6 +421,91 @@ int ui_attr_update_text(ui_runtime_t* rt, uint8_t element_id, const char* new_te
 	return RES_OK;
 }
 
+int ui_attr_resize_text(ui_runtime_t* rt, uint8_t element_id, const char* text, uint8_t capacity)
+{
+	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_TEXT);
+	if (!e) return RES_UNKNOWN_ID;
+	uint8_t len = 0u;
+	if (text) { while (text[len]) len++; }
+	uint8_t cap = capacity ? capacity : len;
+	if ((e[2] & UI_ATTR_TEXT_SIZE_MASK) == (uint8_t)(cap + 1u)) {
+		return ui_attr_update_text(rt, element_id, text);
+	}
+	uint16_t adv = ui_attr_skip_entry(e);
+	if ((uint32_t) rt->head_used - adv + UI_ATTR_SIZE_TEXT_HDR + cap + 1u + rt->used_tail >
+	    (uint32_t) UI_ATTR_ARENA_CAP) {
+		return RES_NO_SPACE;
+	}
+	ui_attr_drop(rt, (uint16_t)(e - rt->arena), adv);
+	ui_attr_reindex(rt);
+	return ui_attr_store_text_with_cap(rt, element_id, text, cap);
+}
+
+#if UI_PERSIST
+/** Static text worth a flash reference: the entry shrinks to UI_ATTR_SIZE_TEXT_FLASH bytes. */
+static uint8_t ui_attr_flashable(const uint8_t* e)
+{
+	return (uint8_t)(e[0] == UI_ATTR_TAG_TEXT && (e[2] & UI_ATTR_TEXT_STATIC) &&
+	                 UI_ATTR_SIZE_TEXT_HDR + (e[2] & UI_ATTR_TEXT_SIZE_MASK) > UI_ATTR_SIZE_TEXT_FLASH);
+}
+
+uint16_t ui_attr_static_text_bytes(ui_runtime_t* rt, uint16_t* freed)
+{
+	uint16_t bytes = 0u;
+	uint16_t off   = rt->attr_base;
+	*freed         = 0u;
+	while (off < rt->head_used) {
+		uint8_t* e   = &rt->arena[off];
+		uint16_t adv = ui_attr_skip_entry(e);
+		if (adv == 0u) break;
+		if (ui_attr_flashable(e)) {
+			bytes  = (uint16_t)(bytes + strlen((const char*)&e[3]) + 1u);
+			*freed = (uint16_t)(*freed + adv - UI_ATTR_SIZE_TEXT_FLASH);
+		}
+		off = (uint16_t)(off + adv);
+	}
+	return bytes;
+}
+
+uint8_t ui_attr_static_text_byte(ui_runtime_t* rt, uint16_t k)
+{
+	uint16_t off = rt->attr_base;
+	while (off < rt->head_used) {
+		uint8_t* e   = &rt->arena[off];
+		uint16_t adv = ui_attr_skip_entry(e);
+		if (adv == 0u) break;
+		if (ui_attr_flashable(e)) {
+			uint16_t n = (uint16_t)(strlen((const char*)&e[3]) + 1u);
+			if (k < n) return e[3 + k];
+			k = (uint16_t)(k - n);
+		}
+		off = (uint16_t)(off + adv);
+	}
+	return 0xFFu;
+}
+
+void ui_attr_flash_static_texts(ui_runtime_t* rt, uint16_t str_off)
+{
+	uint16_t off = rt->attr_base;
+	while (off < rt->head_used) {
+		uint8_t* e   = &rt->arena[off];
+		uint16_t adv = ui_attr_skip_entry(e);
+		if (adv == 0u) break;
+		if (ui_attr_flashable(e)) {
+			uint16_t n = (uint16_t)(strlen((const char*)&e[3]) + 1u);
+			e[0]       = UI_ATTR_TAG_TEXT_FLASH;
+			e[3]       = (uint8_t)str_off;
+			e[4]       = (uint8_t)(str_off >> 8);
+			str_off    = (uint16_t)(str_off + n);
+			ui_attr_drop(rt, (uint16_t)(off + UI_ATTR_SIZE_TEXT_FLASH), (uint16_t)(adv - UI_ATTR_SIZE_TEXT_FLASH));
+			adv = UI_ATTR_SIZE_TEXT_FLASH;
+		}
+		off = (uint16_t)(off + adv);
+	}
+	ui_attr_reindex(rt);
+}
+#endif
+
 int ui_attr_store_position(ui_runtime_t* rt,
                            uint8_t       element_id,
                            uint8_t       x,
@@ -304,28 +541,3 @@ int ui_attr_get_position(ui_runtime_t* rt,
 	*font_size   = 8;
 	return RES_OK;
 }
-
-int ui_attr_store_screen_role(ui_runtime_t* rt, uint8_t element_id, uint8_t role)
-{
-	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_SCREEN_ROLE);
-	if (e) {
-		ui_attr_screen_role_entry_t* sr = (ui_attr_screen_role_entry_t*)e;
-		sr->role = role;
-		return RES_OK;
-	}
-	return ui_attr_append(rt, element_id, UI_ATTR_TAG_SCREEN_ROLE, &role, 0u, 1u);
-}
-
-int ui_attr_get_screen_role(ui_runtime_t* rt, uint8_t element_id, uint8_t* out_role)
-{
-	if (!out_role) {
-		return RES_BAD_LEN;
-	}
-	uint8_t* e = ui_attr_find(rt, element_id, UI_ATTR_TAG_SCREEN_ROLE);
-	if (!e) {
-		return RES_UNKNOWN_ID;
-	}
-	ui_attr_screen_role_entry_t* sr = (ui_attr_screen_role_entry_t*)e;
-	*out_role = sr->role;
-	return RES_OK;
-}
@@ -4,59 +4,316 @@
  */
 #include "ui_tree.h"
 
+#include <stddef.h>
+#include <string.h>
+
+#include "ui_focus.h"
 #include "ui_protocol.h"
 
-uint8_t list_item_count(uint8_t list_eid)
+/**
+ * Non-zero when eid is ancestor or one of its descendants. Parents always have smaller ids
+ * than their children, so the walk stops as soon as it passes below ancestor.
+ */
+static uint8_t element_within(uint8_t eid, uint8_t ancestor)
+{
+  while (eid < g_protocol_state.element_count && eid >= ancestor) {
+    if (eid == ancestor) {
+      return 1u;
+    }
+    eid = g_protocol_state.elements[eid].parent_id;
+  }
+  return 0u;
+}
+
+/**
+ * Keep the pre-order flag (and subtree_end with UI_SUBTREE_INDEX). eid must be the newest
+ * element and its new parent subtree must end right before it (or already hold it when moving
+ * below the old parent); anything else clears the flag and subtree ranges are no longer exact.
+ */
+static void element_index_subtree(uint8_t eid, uint8_t old, uint8_t parent)
+{
+  if (g_protocol_state.preorder == 0u) {
+    return;
+  }
+#if UI_SUBTREE_INDEX
+  uint8_t* end  = g_protocol_state.subtree_end;
+  uint8_t  next = (uint8_t) (eid + 1u);
+  uint8_t  ok   = (next == g_protocol_state.element_count) ? 1u : 0u;
+  if (ok && old < g_protocol_state.element_count && parent != old) {
+    /* Moving down inside the old parent's range keeps every old ancestor range exact */
+    ok = (parent < g_protocol_state.element_count && parent > old && parent < end[old] &&
+          end[parent] == eid)
+           ? 1u
+           : 0u;
+  } else if (ok && old >= g_protocol_state.element_count &&
+             parent < g_protocol_state.element_count) {
+    ok = (end[parent] == eid) ? 1u : 0u;
+  }
+  if (!ok) {
+    g_protocol_state.preorder = 0u;
+    return;
+  }
+  end[eid] = next;
+  for (uint8_t p = parent; p < g_protocol_state.element_count && end[p] != next;
+       p = g_protocol_state.elements[p].parent_id) {
+    end[p] = next;
+  }
+#else
+  uint8_t ok = ((uint8_t) (eid + 1u) == g_protocol_state.element_count) ? 1u : 0u;
+  if (ok && old < g_protocol_state.element_count && parent != old) {
+    /* Moving down inside the old parent's range keeps every old ancestor range exact */
+    ok = (parent < g_protocol_state.element_count && element_within(parent, old) &&
+          element_within((uint8_t) (eid - 1u), parent))
+           ? 1u
+           : 0u;
+  } else if (ok && old >= g_protocol_state.element_count &&
+             parent < g_protocol_state.element_count) {
+    ok = element_within((uint8_t) (eid - 1u), parent);
+  }
+  if (!ok) {
+    g_protocol_state.preorder = 0u;
+  }
+#endif
+}
+
+void element_set_parent(uint8_t eid, uint8_t parent)
+{
+  uint8_t* first = g_protocol_state.first_child;
+  uint8_t* next  = g_protocol_state.next_sibling;
+  uint8_t  old   = g_protocol_state.elements[eid].parent_id;
+  if (old < g_protocol_state.element_count) {
+    uint8_t* link = &first[old];
+    while (*link != INVALID_ELEMENT_ID && *link != eid) {
+      link = &next[*link];
+    }
+    if (*link == eid) {
+      *link = next[eid];
+    }
+  }
+  g_protocol_state.elements[eid].parent_id = parent;
+  next[eid]                                = INVALID_ELEMENT_ID;
+#if UI_SCREEN_CACHE
+  /* Screen ownership is resolved once; eid has no children yet when it is (re)parented */
+  uint8_t is_screen = (g_protocol_state.elements[eid].type == ELEMENT_SCREEN) ? 1u : 0u;
+  uint8_t root      = is_screen ? eid : INVALID_ELEMENT_ID;
+  uint8_t top       = root;
+#endif
+  if (parent < g_protocol_state.element_count) {
+    uint8_t* link = &first[parent];
+    while (*link != INVALID_ELEMENT_ID) {
+      link = &next[*link];
+    }
+    *link = eid;
+#if UI_SCREEN_CACHE
+    if (!is_screen) {
+      root = g_protocol_state.root_screen[parent];
+    }
+    top = g_protocol_state.top_screen[parent];
+#endif
+  }
+#if UI_SCREEN_CACHE
+  g_protocol_state.root_screen[eid] = root;
+  g_protocol_state.top_screen[eid]  = top;
+#endif
+  element_index_subtree(eid, old, parent);
+  protocol_invalidate_visibility();
+}
+
+void element_rebuild_tables(void)
+{
+  uint8_t n   = g_protocol_state.element_count;
+  uint8_t cap = g_protocol_state.element_capacity;
+  memset(g_protocol_state.first_child, INVALID_ELEMENT_ID, cap);
+  memset(g_protocol_state.next_sibling, INVALID_ELEMENT_ID, cap);
+#if UI_SUBTREE_INDEX
+  memset(g_protocol_state.subtree_end, 0, cap);
+#endif
+  g_protocol_state.preorder = 1u;
+  /* Replay creation in id order: parents precede children, so every table rebuilds as it did */
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t parent                         = g_protocol_state.elements[i].parent_id;
+    g_protocol_state.elements[i].parent_id = INVALID_ELEMENT_ID;
+    g_protocol_state.element_count         = (uint8_t) (i + 1u);
+    element_set_parent(i, parent);
+  }
+  g_protocol_state.element_count = n;
+  /* Base screens keep their marker in screen_ords and are renumbered in id order */
+  g_protocol_state.screen_count = 0u;
+  for (uint8_t i = 0; i < n; i++) {
+    if (g_protocol_state.screen_ords[i] != INVALID_ELEMENT_ID) {
+      g_protocol_state.screen_ids[g_protocol_state.screen_count] = i;
+      g_protocol_state.screen_ords[i] = g_protocol_state.screen_count++;
+    }
+  }
+}
+
+uint8_t element_range_end(uint8_t eid, uint8_t limit)
+{
+  /* In pre-order, an element belongs to the range while its parent does */
+  uint8_t i = (uint8_t) (eid + 1u);
+  while (i < limit) {
+    uint8_t parent = g_protocol_state.elements[i].parent_id;
+    if (parent == INVALID_ELEMENT_ID || parent < eid) {
+      break;
+    }
+    i++;
+  }
+  return i;
+}
+
+uint8_t element_subtree_end(uint8_t eid)
+{
+  if (eid >= g_protocol_state.element_count) {
+    return eid;
+  }
+  if (g_protocol_state.preorder != 0u) {
+#if UI_SUBTREE_INDEX
+    return g_protocol_state.subtree_end[eid];
+#else
+    return element_range_end(eid, g_protocol_state.element_count);
+#endif
+  }
+  return g_protocol_state.element_count;
+}
+
+uint8_t element_next_child(uint8_t parent, uint8_t prev, uint8_t type)
+{
+  uint8_t i;
+  if (prev == INVALID_ELEMENT_ID) {
+    if (parent >= g_protocol_state.element_count) {
+      return INVALID_ELEMENT_ID;
+    }
+    i = g_protocol_state.first_child[parent];
+  } else {
+    i = g_protocol_state.next_sibling[prev];
+  }
+  while (i != INVALID_ELEMENT_ID && g_protocol_state.elements[i].type != type) {
+    i = g_protocol_state.next_sibling[i];
+  }
+  return i;
+}
+
+/** Return the row table of a list built at COMMIT, or NULL before COMMIT / when it did not fit. */
+const uint8_t* list_row_table(uint8_t list_eid, uint8_t* out_count)
+{
+  ui_runtime_t*    rt = &g_protocol_state.runtime;
+  ur_list_state_t* ls = ur_list_find(rt, list_eid);
+  if (ls == NULL || ls->rows_off == 0u) {
+    return NULL;
+  }
+  if (out_count) {
+    *out_count = ls->row_count;
+  }
+  return (const uint8_t*) ur__ptr(rt, ls->rows_off);
+}
+
+/** Walk TEXT children of a list in creation order; fill out (if non-NULL) and return count. */
+static uint8_t list_scan_rows(uint8_t list_eid, uint8_t* out)
 {
   uint8_t cnt = 0;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* el = &g_protocol_state.elements[i];
-    if (el->parent_id == list_eid && el->type == ELEMENT_TEXT) {
-      cnt++;
+  for (uint8_t i = element_next_child(list_eid, INVALID_ELEMENT_ID, ELEMENT_TEXT);
+       i != INVALID_ELEMENT_ID;
+       i = element_next_child(list_eid, i, ELEMENT_TEXT)) {
+    if (out) {
+      out[cnt] = i;
     }
+    cnt++;
   }
   return cnt;
 }
 
-uint8_t list_row_count(uint8_t list_eid)
+void list_build_row_tables(void)
 {
-  uint8_t count = 0u;
+  ui_runtime_t* rt = &g_protocol_state.runtime;
   for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* el = &g_protocol_state.elements[i];
-    if (el->parent_id != list_eid) {
+    ur_list_state_t* ls = ur_list_find(rt, i);
+    if (!ls) {
       continue;
     }
-    if (el->type != ELEMENT_TEXT) {
-      continue;
+    ls->rows_off  = 0u;
+    ls->row_count = list_scan_rows(ls->element_id, NULL);
+    if (ls->row_count != 0u) {
+      /* Keep the tail 2-byte aligned for the nodes allocated after it */
+      uint8_t* rows = (uint8_t*) ur__alloc_tail(rt, (uint16_t) ((ls->row_count + 1u) & ~1u));
+      if (rows) {
+        (void) list_scan_rows(ls->element_id, rows);
+        ls->rows_off = ur__off(rt, rows);
+      }
     }
-    if (protocol_is_element_visible(i) == 0u) {
-      continue;
+  }
+}
+
+uint8_t list_item_count(uint8_t list_eid)
+{
+  uint8_t count = 0u;
+  if (list_row_table(list_eid, &count)) {
+    return count;
+  }
+  return list_scan_rows(list_eid, NULL);
+}
+
+uint8_t list_item_by_index(uint8_t list_eid, uint8_t row_index)
+{
+  uint8_t        count = 0u;
+  const uint8_t* rows  = list_row_table(list_eid, &count);
+  if (rows) {
+    return (row_index < count) ? rows[row_index] : INVALID_ELEMENT_ID;
+  }
+  for (uint8_t i = element_next_child(list_eid, INVALID_ELEMENT_ID, ELEMENT_TEXT);
+       i != INVALID_ELEMENT_ID;
+       i = element_next_child(list_eid, i, ELEMENT_TEXT)) {
+    if (count == row_index) {
+      return i;
     }
     count++;
   }
-  return count;
+  return INVALID_ELEMENT_ID;
 }
 
-uint8_t list_child_by_index(uint8_t list_eid, uint8_t row_index)
+/**
+ * Walk visible rows of a list (row table when built, child chain otherwise).
+ * Stops at text_eid or at the row_index-th visible row, whichever is requested.
+ * Returns the number of visible rows passed; *out_eid receives the stopping row.
+ */
+static uint8_t list_walk_visible(uint8_t list_eid, uint8_t stop_eid, uint8_t stop_row, uint8_t* out_eid)
 {
-  uint8_t count = 0u;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* child = &g_protocol_state.elements[i];
-    if (child->parent_id != list_eid) {
-      continue;
+  uint8_t        count = 0u;
+  const uint8_t* rows  = list_row_table(list_eid, &count);
+  uint8_t        row   = 0u;
+  uint8_t        i     = INVALID_ELEMENT_ID;
+  for (uint8_t k = 0;; k++) {
+    if (rows) {
+      i = (k < count) ? rows[k] : INVALID_ELEMENT_ID;
+    } else {
+      i = element_next_child(list_eid, i, ELEMENT_TEXT);
     }
-    if (child->type != ELEMENT_TEXT) {
-      continue;
+    if (i == INVALID_ELEMENT_ID) {
+      break;
     }
     if (protocol_is_element_visible(i) == 0u) {
       continue;
     }
-    if (count == row_index) {
-      return (uint8_t) i;
+    if (i == stop_eid || row == stop_row) {
+      *out_eid = i;
+      return row;
     }
-    count++;
+    row++;
   }
-  return INVALID_ELEMENT_ID;
+  *out_eid = INVALID_ELEMENT_ID;
+  return row;
+}
+
+uint8_t list_row_count(uint8_t list_eid)
+{
+  uint8_t eid = INVALID_ELEMENT_ID;
+  return list_walk_visible(list_eid, INVALID_ELEMENT_ID, INVALID_ELEMENT_ID, &eid);
+}
+
+uint8_t list_child_by_index(uint8_t list_eid, uint8_t row_index)
+{
+  uint8_t eid = INVALID_ELEMENT_ID;
+  (void) list_walk_visible(list_eid, INVALID_ELEMENT_ID, row_index, &eid);
+  return eid;
 }
 
 uint8_t list_row_index_of_text(uint8_t list_eid, uint8_t text_eid)
@@ -67,38 +324,14 @@ uint8_t list_row_index_of_text(uint8_t list_eid, uint8_t text_eid)
   if (text_eid >= g_protocol_state.element_count) {
     return INVALID_ELEMENT_ID;
   }
-  uint8_t row = 0u;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    const element_t* child = &g_protocol_state.elements[i];
-    if (child->parent_id != list_eid) {
-      continue;
-    }
-    if (child->type != ELEMENT_TEXT) {
-      continue;
-    }
-    if (protocol_is_element_visible(i) == 0u) {
-      continue;
-    }
-    if (i == text_eid) {
-      return row;
-    }
-    row++;
-  }
-  return INVALID_ELEMENT_ID;
+  uint8_t eid = INVALID_ELEMENT_ID;
+  uint8_t row = list_walk_visible(list_eid, text_eid, INVALID_ELEMENT_ID, &eid);
+  return (eid == INVALID_ELEMENT_ID) ? INVALID_ELEMENT_ID : row;
 }
 
 uint8_t text_inline_barrel_id(uint8_t text_eid)
 {
-  for (uint8_t eid = 0; eid < g_protocol_state.element_count; eid++) {
-    const element_t* child = &g_protocol_state.elements[eid];
-    if (child->parent_id != text_eid) {
-      continue;
-    }
-    if (child->type == ELEMENT_BARREL) {
-      return eid;
-    }
-  }
-  return INVALID_ELEMENT_ID;
+  return element_next_child(text_eid, INVALID_ELEMENT_ID, ELEMENT_BARREL);
 }
 
 uint8_t element_parent_list(uint8_t eid)
@@ -124,18 +357,10 @@ uint8_t element_parent_list(uint8_t eid)
 
 uint8_t find_screen_id_by_ordinal(uint8_t sord)
 {
-  uint8_t seen = 0U;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    if (g_protocol_state.elements[i].type == ELEMENT_SCREEN &&
-        protocol_screen_role(i) == OVERLAY_NONE &&
-        g_protocol_state.elements[i].parent_id == INVALID_ELEMENT_ID) {
-      if (seen == sord) {
-        return i;
-      }
-      seen++;
-    }
+  if (sord >= g_protocol_state.screen_count) {
+    return INVALID_ELEMENT_ID;
   }
-  return INVALID_ELEMENT_ID;
+  return g_protocol_state.screen_ids[sord];
 }
 
 uint8_t find_screen_ordinal_by_id(uint8_t screen_id)
@@ -143,47 +368,40 @@ uint8_t find_screen_ordinal_by_id(uint8_t screen_id)
   if (screen_id >= g_protocol_state.element_count) {
     return INVALID_ELEMENT_ID;
   }
-  if (g_protocol_state.elements[screen_id].type != ELEMENT_SCREEN) {
-    return INVALID_ELEMENT_ID;
-  }
-  if (g_protocol_state.elements[screen_id].parent_id != INVALID_ELEMENT_ID) {
+  return g_protocol_state.screen_ords[screen_id];
+}
+
+uint8_t element_root_screen(uint8_t eid)
+{
+#if UI_SCREEN_CACHE
+  if (eid >= g_protocol_state.element_count) {
     return INVALID_ELEMENT_ID;
   }
-  uint8_t ord = 0u;
-  for (uint8_t i = 0; i < g_protocol_state.element_count; i++) {
-    if (g_protocol_state.elements[i].type != ELEMENT_SCREEN) {
-      continue;
-    }
-    if (protocol_screen_role(i) != OVERLAY_NONE) {
-      continue;
-    }
-    if (i == screen_id) {
-      return ord;
+  return g_protocol_state.root_screen[eid];
+#else
+  while (eid < g_protocol_state.element_count) {
+    if (g_protocol_state.elements[eid].type == ELEMENT_SCREEN) {
+      return eid;
     }
-    ord++;
+    eid = g_protocol_state.elements[eid].parent_id;
   }
   return INVALID_ELEMENT_ID;
+#endif
 }
 
-uint8_t element_root_screen(uint8_t eid)
+uint8_t element_top_screen(uint8_t eid)
 {
   if (eid >= g_protocol_state.element_count) {
     return INVALID_ELEMENT_ID;
   }
-  uint8_t current = eid;
-  for (uint16_t depth = 0; depth < g_protocol_state.element_count; depth++) {
-    if (current == INVALID_ELEMENT_ID) {
-      break;
-    }
-    if (current >= g_protocol_state.element_count) {
-      break;
-    }
-    if (g_protocol_state.elements[current].type == ELEMENT_SCREEN) {
-      return current;
-    }
-    current = g_protocol_state.elements[current].parent_id;
+#if UI_SCREEN_CACHE
+  return g_protocol_state.top_screen[eid];
+#else
+  while (g_protocol_state.elements[eid].parent_id < g_protocol_state.element_count) {
+    eid = g_protocol_state.elements[eid].parent_id;
   }
-  return INVALID_ELEMENT_ID;
+  return (g_protocol_state.elements[eid].type == ELEMENT_SCREEN) ? eid : INVALID_ELEMENT_ID;
+#endif
 }
 
 uint8_t is_descendant_of(uint8_t eid, uint8_t ancestor)
@@ -191,18 +409,13 @@ uint8_t is_descendant_of(uint8_t eid, uint8_t ancestor)
   if (ancestor == INVALID_ELEMENT_ID) {
     return 0u;
   }
-  uint8_t current = eid;
-  for (uint16_t depth = 0; depth < g_protocol_state.element_count; depth++) {
-    if (current == INVALID_ELEMENT_ID) {
-      break;
-    }
-    if (current >= g_protocol_state.element_count) {
-      break;
-    }
-    if (current == ancestor) {
-      return 1u;
-    }
-    current = g_protocol_state.elements[current].parent_id;
+#if UI_SUBTREE_INDEX
+  if (g_protocol_state.preorder != 0u) {
+    return (ancestor < g_protocol_state.element_count && eid >= ancestor &&
+            eid < g_protocol_state.subtree_end[ancestor])
+             ? 1u
+             : 0u;
   }
-  return 0u;
+#endif
+  return element_within(eid, ancestor);
 }
@@ -0,0 +1,372 @@
+/**
+ * @file test_gfx_raster.c
+ * @brief Native test: raster ops clipped to the panel edges and the current page.
+ *
+ * Fills, inversions, lines and bitmap blits are checked against a per-pixel reference
+ * over all eight pages, so a wrong row mask, column span or blit shift shows up as the
+ * first differing column.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "gfx_raster.h"
+#include "ssd1306_driver.h"
+
+#define PANEL_PAGES 8u
+
+/* ---- Hardware and platform stubs ---- */
+
+uint32_t get_system_time_ms(void)
+{
+  return 0u;
+}
+
+void debug_log_event(uint8_t type, uint8_t value)
+{
+  (void) type;
+  (void) value;
+}
+
+void debug_led_process(void) {}
+
+void spi_slave_tx_dma_start(const uint8_t* buffer, uint16_t length)
+{
+  (void) buffer;
+  (void) length;
+}
+
+int spi_slave_tx_dma_is_complete(void)
+{
+  return 1;
+}
+
+i2c_err_t i2c_init(i2c_device_t* dev)
+{
+  (void) dev;
+  return I2C_OK;
+}
+
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status))
+{
+  (void) callback;
+}
+
+int i2c_tx_dma_busy(void)
+{
+  return 0;
+}
+
+i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len)
+{
+  (void) dev;
+  (void) buf;
+  (void) len;
+  return I2C_OK;
+}
+
+/* ---- Reference ---- */
+
+/** Operations under test; lines take their length from w (hline) or h (vline). */
+typedef enum {
+  DRAW_FILL,
+  DRAW_INVERT,
+  DRAW_HLINE,
+  DRAW_VLINE,
+} draw_op_t;
+
+/** Bitmap blitted by check_blit(): up to 3 source rows of up to 40 columns. */
+static uint8_t g_bitmap[3u * 40u];
+
+/** Pattern every page starts from, so set, clear and XOR all show. */
+static uint8_t pattern(uint8_t col)
+{
+  return (uint8_t) (col * 37u);
+}
+
+/** 1 when panel pixel (col, row) lies in the rectangle. */
+static uint8_t covers(int16_t x, int16_t y, uint8_t w, uint8_t h, int16_t col, int16_t row)
+{
+  return (uint8_t) (col >= x && col < x + w && row >= y && row < y + h);
+}
+
+/** Page byte after the operation, one pixel at a time. */
+static uint8_t reference_byte(draw_op_t op,
+                              int16_t   x,
+                              int16_t   y,
+                              uint8_t   w,
+                              uint8_t   h,
+                              uint8_t   color,
+                              uint8_t   page_top,
+                              int16_t   col)
+{
+  uint8_t byte = pattern((uint8_t) col);
+  for (uint8_t b = 0; b < GFX_PAGE_HEIGHT; b++) {
+    int16_t row = (int16_t) (page_top + b);
+    uint8_t bit = (uint8_t) (1u << b);
+    if (!covers(x, y, w, h, col, row)) {
+      continue;
+    }
+    if (op == DRAW_INVERT) {
+      byte ^= bit;
+    } else if (color != 0u) {
+      byte |= bit;
+    } else {
+      byte &= (uint8_t) ~bit;
+    }
+  }
+  return byte;
+}
+
+/** Page byte after blitting g_bitmap, one pixel at a time. */
+static uint8_t reference_blit_byte(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t page_top, int16_t col)
+{
+  uint8_t byte = pattern((uint8_t) col);
+  for (uint8_t b = 0; b < GFX_PAGE_HEIGHT; b++) {
+    int16_t row = (int16_t) (page_top + b);
+    if (!covers(x, y, w, h, col, row)) {
+      continue;
+    }
+    uint8_t sr = (uint8_t) (row - y);
+    uint8_t sc = (uint8_t) (col - x);
+    if (g_bitmap[(uint16_t) (sr >> 3) * w + sc] & (1u << (sr & 7u))) {
+      byte |= (uint8_t) (1u << b);
+    }
+  }
+  return byte;
+}
+
+/** Fill the page with the pattern and the expected bytes with the reference. */
+static uint8_t* start_page(uint8_t* expect)
+{
+  uint8_t* buf = gfx_get_shared_buffer();
+  for (uint8_t c = 0; c < GFX_TILE_WIDTH; c++) {
+    buf[c]    = pattern(c);
+    expect[c] = buf[c];
+  }
+  return buf;
+}
+
+/** Run one operation on every page over the pattern and compare with the reference. */
+static void check_op(draw_op_t op, int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+  static const char* const names[] = {"fill", "invert", "hline", "vline"};
+  uint8_t                  expect[GFX_TILE_WIDTH];
+  char                     msg[64];
+  for (uint8_t page = 0; page < PANEL_PAGES; page++) {
+    uint8_t  page_top = (uint8_t) (page * GFX_PAGE_HEIGHT);
+    uint8_t* buf      = start_page(expect);
+    for (uint8_t c = 0; c < GFX_TILE_WIDTH; c++) {
+      expect[c] = reference_byte(op, x, y, w, h, color, page_top, c);
+    }
+    switch (op) {
+      case DRAW_FILL:
+        gfx_fill_rect(x, y, w, h, page_top, color);
+        break;
+      case DRAW_INVERT:
+        gfx_invert_rect(x, y, w, h, page_top);
+        break;
+      case DRAW_HLINE:
+        gfx_hline(x, y, w, page_top, color);
+        break;
+      case DRAW_VLINE:
+        gfx_vline(x, y, h, page_top, color);
+        break;
+    }
+    snprintf(msg, sizeof(msg), "%s %d,%d %ux%u c%u page %u", names[op], x, y, w, h,
+             (unsigned) color, (unsigned) page);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, buf, GFX_TILE_WIDTH, msg);
+    if (op == DRAW_INVERT) {
+      /* XOR twice restores the page */
+      gfx_invert_rect(x, y, w, h, page_top);
+      for (uint8_t c = 0; c < GFX_TILE_WIDTH; c++) {
+        expect[c] = pattern(c);
+      }
+      TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, buf, GFX_TILE_WIDTH, msg);
+    }
+  }
+}
+
+static void check_rect(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+  check_op(DRAW_INVERT, x, y, w, h, 0u);
+}
+
+/** Set and clear the same rectangle. */
+static void check_fill(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+  check_op(DRAW_FILL, x, y, w, h, 1u);
+  check_op(DRAW_FILL, x, y, w, h, 0u);
+}
+
+/** Both colors of a w pixel horizontal line at (x, y). */
+static void check_hline(int16_t x, int16_t y, uint8_t w)
+{
+  check_op(DRAW_HLINE, x, y, w, 1u, 1u);
+  check_op(DRAW_HLINE, x, y, w, 1u, 0u);
+}
+
+/** Both colors of an h pixel vertical line at (x, y). */
+static void check_vline(int16_t x, int16_t y, uint8_t h)
+{
+  check_op(DRAW_VLINE, x, y, 1u, h, 1u);
+  check_op(DRAW_VLINE, x, y, 1u, h, 0u);
+}
+
+/** Blit a pseudo-random w x h bitmap on every page and compare with the reference. */
+static void check_blit(int16_t x, int16_t y, uint8_t w, uint8_t h)
+{
+  uint8_t expect[GFX_TILE_WIDTH];
+  char    msg[64];
+  TEST_ASSERT_TRUE(w <= 40u && h <= 24u);
+  for (uint16_t i = 0; i < sizeof(g_bitmap); i++) {
+    g_bitmap[i] = (uint8_t) (i * 73u + 11u);
+  }
+  for (uint8_t page = 0; page < PANEL_PAGES; page++) {
+    uint8_t  page_top = (uint8_t) (page * GFX_PAGE_HEIGHT);
+    uint8_t* buf      = start_page(expect);
+    for (uint8_t c = 0; c < GFX_TILE_WIDTH; c++) {
+      expect[c] = reference_blit_byte(x, y, w, h, page_top, c);
+    }
+    gfx_blit_bitmap(x, y, g_bitmap, w, h, page_top);
+    snprintf(msg, sizeof(msg), "blit %d,%d %ux%u page %u", x, y, w, h, (unsigned) page);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, buf, GFX_TILE_WIDTH, msg);
+  }
+}
+
+void setUp(void)
+{
+  gfx_clear_shared_buffer();
+}
+
+void tearDown(void) {}
+
+/* ---- Cases ---- */
+
+/** Rectangles inside one page, aligned and at odd rows. */
+static void test_invert_inside_page(void)
+{
+  check_rect(10, 8, 20, 8);
+  check_rect(0, 0, GFX_TILE_WIDTH, 1u);
+  check_rect(3, 19, 7, 3);
+}
+
+/** Rows crossing a page boundary keep only this page's share on each page. */
+static void test_invert_clips_to_page(void)
+{
+  check_rect(4, 5, 9, 6);
+  check_rect(4, 13, 1, 20);
+  check_rect(0, 0, GFX_TILE_WIDTH, 64u);
+}
+
+/** Columns left of 0 and right of the panel are dropped, the rest kept. */
+static void test_invert_clips_panel_edges(void)
+{
+  check_rect(-3, 8, 6, 8);
+  check_rect(125, 8, 10, 8);
+  check_rect(-20, 30, 200, 4);
+  check_rect(GFX_TILE_WIDTH - 1, 0, 1u, 8u);
+  check_rect(0, -4, 8, 6);
+  check_rect(0, 60, 8, 10);
+}
+
+/** Nothing visible: empty, fully left, fully right, above or below the panel. */
+static void test_invert_outside_is_noop(void)
+{
+  check_rect(10, 10, 0u, 5u);
+  check_rect(10, 10, 5u, 0u);
+  check_rect(-8, 0, 8u, 8u);
+  check_rect(GFX_TILE_WIDTH, 0, 8u, 8u);
+  check_rect(0, -9, 8u, 8u);
+  check_rect(0, 64, 8u, 8u);
+}
+
+/** Fills inside a page, across pages, partly off the panel and fully off it. */
+static void test_fill_rect(void)
+{
+  check_fill(10, 8, 20, 8);
+  check_fill(3, 19, 7, 3);
+  check_fill(4, 5, 9, 30);
+  check_fill(-3, -2, 6, 12);
+  check_fill(120, 58, 20, 10);
+  check_fill(-20, 30, 200, 4);
+  check_fill(10, 10, 0u, 5u);
+  check_fill(-8, 0, 8u, 8u);
+  check_fill(GFX_TILE_WIDTH, 0, 8u, 8u);
+  check_fill(0, -9, 8u, 8u);
+  check_fill(0, 64, 8u, 8u);
+}
+
+/** Horizontal lines on each row of a page, clipped at both panel edges or off it. */
+static void test_hline(void)
+{
+  for (int16_t y = 0; y < 16; y += 3) {
+    check_hline(5, y, 30u);
+  }
+  check_hline(-10, 9, 20u);
+  check_hline(100, 63, 60u);
+  check_hline(-5, 12, 255u);
+  check_hline(0, -1, 10u);
+  check_hline(0, 64, 10u);
+  check_hline(-10, 12, 10u);
+  check_hline(GFX_TILE_WIDTH, 12, 10u);
+  check_hline(7, 12, 0u);
+}
+
+/** Vertical lines inside a page, across pages, clipped at the top and bottom or off it. */
+static void test_vline(void)
+{
+  check_vline(0, 0, 8u);
+  check_vline(17, 3, 3u);
+  check_vline(40, 5, 30u);
+  check_vline(GFX_TILE_WIDTH - 1, -4, 10u);
+  check_vline(64, 60, 20u);
+  check_vline(-1, 0, 64u);
+  check_vline(GFX_TILE_WIDTH, 0, 64u);
+  check_vline(20, -30, 10u);
+  check_vline(20, 64, 10u);
+  check_vline(20, 10, 0u);
+}
+
+/** Bitmaps at page-aligned and unaligned rows, so one or two source rows feed a page. */
+static void test_blit_bitmap_shift(void)
+{
+  check_blit(10, 8, 16u, 8u);
+  check_blit(10, 16, 16u, 16u);
+  check_blit(10, 3, 16u, 8u);
+  check_blit(33, 13, 12u, 13u);
+  check_blit(5, 21, 40u, 24u);
+  check_blit(0, 7, 1u, 2u);
+}
+
+/** Bitmaps clipped at every panel edge or fully off it; NULL draws nothing. */
+static void test_blit_bitmap_clips(void)
+{
+  uint8_t expect[GFX_TILE_WIDTH];
+  check_blit(-5, 2, 16u, 12u);
+  check_blit(120, 9, 16u, 12u);
+  check_blit(20, -5, 16u, 12u);
+  check_blit(20, 58, 16u, 12u);
+  check_blit(-16, 0, 16u, 8u);
+  check_blit(GFX_TILE_WIDTH, 0, 16u, 8u);
+  check_blit(0, -12, 16u, 12u);
+  check_blit(0, 64, 16u, 8u);
+  uint8_t* buf = start_page(expect);
+  gfx_blit_bitmap(0, 0, NULL, 8u, 8u, 0u);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, buf, GFX_TILE_WIDTH, "blit NULL");
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_invert_inside_page);
+  RUN_TEST(test_invert_clips_to_page);
+  RUN_TEST(test_invert_clips_panel_edges);
+  RUN_TEST(test_invert_outside_is_noop);
+  RUN_TEST(test_fill_rect);
+  RUN_TEST(test_hline);
+  RUN_TEST(test_vline);
+  RUN_TEST(test_blit_bitmap_shift);
+  RUN_TEST(test_blit_bitmap_clips);
+  return UNITY_END();
+}
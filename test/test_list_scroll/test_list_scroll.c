@@ -0,0 +1,499 @@
+/**
+ * @file test_list_scroll.c
+ * @brief Native test: list scrolling through the SSD1306 display start line.
+ *
+ * The real renderer and driver stream into an emulated SSD1306 (GDDRAM, address window
+ * and start line decoded from the I2C byte stream). After every animation step the
+ * panel image composed from GDDRAM and the start line must equal the image the
+ * software path draws for the same UI state.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "ssd1306_driver.h"
+#include "status_codes.h"
+#include "ui_buttons.h"
+#include "ui_protocol.h"
+#include "ui_runtime.h"
+
+#define PANEL_RAM_PAGES 8u
+#define PANEL_RAM_ROWS 64u
+#define LIST_ITEMS 12u
+
+/** Emulated SSD1306 controller state (horizontal addressing mode only). */
+typedef struct {
+  uint8_t  ram[PANEL_RAM_PAGES][SSD1306_WIDTH];
+  uint8_t  start_line;
+  uint8_t  col_start, col_end, page_start, page_end;
+  uint8_t  col, page;
+  uint8_t  cmd;       /* command awaiting arguments */
+  uint8_t  args[2];
+  uint8_t  arg_count;
+  uint8_t  arg_need;
+} fake_panel_t;
+
+static fake_panel_t g_panel;
+static uint32_t     g_now_ms;
+static uint8_t      g_pages_built; /* page callbacks since the last reset of the counter */
+static uint16_t     g_tick_ms;     /* main-loop time between animation ticks */
+static uint8_t      g_data_xfers;  /* I2C transactions that carried GDDRAM bytes */
+static void (*g_tx_done_cb)(i2c_err_t status);  /* driver hook for the DMA completion interrupt */
+static uint8_t      g_tx_pending;  /* bus polls until the pending transfer completes */
+static uint8_t      g_tx_fail;     /* next transfer is lost and completes with a DMA error */
+static uint8_t      g_tx_instant;  /* transfers complete before i2c_write_raw_dma() returns */
+static i2c_err_t    g_tx_status;   /* status the pending transfer completes with */
+static uint8_t      g_overlapped_builds; /* pages built while a transfer was in flight */
+static uint8_t      g_in_irq;      /* the completion interrupt is running */
+static uint8_t      g_irq_xfers;   /* transfers launched from the completion interrupt */
+
+/* ---- Hardware and platform stubs ---- */
+
+uint32_t get_system_time_ms(void)
+{
+  return g_now_ms;
+}
+
+void debug_log_event(uint8_t type, uint8_t value)
+{
+  (void) type;
+  (void) value;
+}
+
+void debug_led_process(void) {}
+
+void spi_slave_tx_dma_start(const uint8_t* buffer, uint16_t length)
+{
+  (void) buffer;
+  (void) length;
+}
+
+int spi_slave_tx_dma_is_complete(void)
+{
+  return 1;
+}
+
+i2c_err_t i2c_init(i2c_device_t* dev)
+{
+  (void) dev;
+  return I2C_OK;
+}
+
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status))
+{
+  g_tx_done_cb = callback;
+}
+
+/** A transfer stays busy for one poll; its completion interrupt fires on the second. */
+int i2c_tx_dma_busy(void)
+{
+  if (g_tx_pending != 0u && --g_tx_pending == 0u && g_tx_done_cb) {
+    g_in_irq = 1u;
+    g_tx_done_cb(g_tx_status);
+    g_in_irq = 0u;
+  }
+  return g_tx_pending != 0u;
+}
+
+/** Number of argument bytes following an SSD1306 command byte. */
+static uint8_t fake_panel_arg_count(uint8_t cmd)
+{
+  switch (cmd) {
+    case SSD1306_CMD_SET_COL_ADDR:
+    case SSD1306_CMD_SET_PAGE_ADDR:
+      return 2u;
+    case SSD1306_CMD_SET_DISPLAY_CLOCK_DIV:
+    case SSD1306_CMD_SET_MULTIPLEX:
+    case SSD1306_CMD_SET_DISPLAY_OFFSET:
+    case SSD1306_CMD_CHARGE_PUMP:
+    case SSD1306_CMD_MEMORY_MODE:
+    case SSD1306_CMD_SET_COMPINS:
+    case SSD1306_CMD_SET_CONTRAST:
+    case SSD1306_CMD_SET_PRECHARGE:
+    case SSD1306_CMD_SET_VCOM_DETECT:
+      return 1u;
+    default:
+      return 0u;
+  }
+}
+
+static void fake_panel_command(uint8_t byte)
+{
+  fake_panel_t* p = &g_panel;
+  if (p->arg_need != 0u) {
+    p->args[p->arg_count++] = byte;
+    if (p->arg_count < p->arg_need) {
+      return;
+    }
+    p->arg_need = 0u;
+    if (p->cmd == SSD1306_CMD_SET_COL_ADDR) {
+      p->col_start = p->args[0];
+      p->col_end   = p->args[1];
+      p->col       = p->col_start;
+    } else if (p->cmd == SSD1306_CMD_SET_PAGE_ADDR) {
+      p->page_start = p->args[0];
+      p->page_end   = p->args[1];
+      p->page       = p->page_start;
+    }
+    return;
+  }
+  if (byte >= SSD1306_CMD_SET_START_LINE_0 && byte <= 0x7Fu) {
+    p->start_line = (uint8_t) (byte & 0x3Fu);
+    return;
+  }
+  p->cmd       = byte;
+  p->arg_count = 0u;
+  p->arg_need  = fake_panel_arg_count(byte);
+}
+
+static void fake_panel_data(uint8_t byte)
+{
+  fake_panel_t* p = &g_panel;
+  p->ram[p->page & 7u][p->col & 0x7Fu] = byte;
+  if (p->col >= p->col_end) {
+    p->col = p->col_start;
+    p->page = (p->page >= p->page_end) ? p->page_start : (uint8_t) (p->page + 1u);
+  } else {
+    p->col++;
+  }
+}
+
+/** Decode one I2C transaction: control bytes with Co=1 carry a single byte each. */
+i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len)
+{
+  (void) dev;
+  uint8_t carried_data = 0u;
+  size_t  i            = 0;
+  g_tx_pending         = 2u;
+  g_tx_status          = I2C_OK;
+  g_irq_xfers          = (uint8_t) (g_irq_xfers + g_in_irq);
+  if (g_tx_fail != 0u) {
+    g_tx_fail   = 0u;
+    g_tx_status = I2C_ERR_BERR;
+    return I2C_OK;
+  }
+  while (i < len) {
+    uint8_t control = buf[i++];
+    size_t  end     = (control & 0x80u) ? i + 1u : len;
+    for (; i < end && i < len; i++) {
+      if (control & 0x40u) {
+        fake_panel_data(buf[i]);
+        carried_data = 1u;
+      } else {
+        fake_panel_command(buf[i]);
+      }
+    }
+  }
+  g_data_xfers = (uint8_t) (g_data_xfers + carried_data);
+  if (g_tx_instant != 0u) {
+    g_tx_pending = 0u;
+    if (g_tx_done_cb) {
+      g_tx_done_cb(I2C_OK);
+    }
+  }
+  return I2C_OK;
+}
+
+/* ---- Helpers ---- */
+
+/** Page callback that counts the pages each step rebuilds. */
+static void counting_tile(uint8_t tile_y)
+{
+  g_pages_built++;
+  g_overlapped_builds = (uint8_t) (g_overlapped_builds + (g_tx_pending != 0u));
+  render_screen_tile(tile_y);
+}
+
+/** Run the main-loop render steps until the panel is idle. */
+static void pump_frames(void)
+{
+  for (int guard = 0; guard < 100000; guard++) {
+    ssd1306_render_async_process();
+    if (g_render_requested) {
+      g_render_requested = 0;
+      ssd1306_render_async_start_or_request(counting_tile);
+    }
+    if (!ssd1306_render_async_busy() && !g_render_requested) {
+      return;
+    }
+  }
+  TEST_FAIL_MESSAGE("render did not settle");
+}
+
+/** Panel page as the viewer sees it: GDDRAM rows read through the start line. */
+static void panel_page(uint8_t page, uint8_t* out)
+{
+  for (uint8_t c = 0; c < SSD1306_WIDTH; c++) {
+    uint8_t byte = 0u;
+    for (uint8_t b = 0; b < 8u; b++) {
+      uint8_t row = (uint8_t) ((page * 8u + b + g_panel.start_line) & (PANEL_RAM_ROWS - 1u));
+      if (g_panel.ram[row >> 3][c] & (1u << (row & 7u))) {
+        byte |= (uint8_t) (1u << b);
+      }
+    }
+    out[c] = byte;
+  }
+}
+
+/** Compare the composed panel with the software path at start line 0. */
+static void assert_panel_matches_software(const char* what)
+{
+  uint8_t expect[SSD1306_WIDTH];
+  uint8_t actual[SSD1306_WIDTH];
+  char    msg[64];
+  render_frame_resolve();
+  for (uint8_t page = 0; page < ssd1306_pages(); page++) {
+    gfx_clear_shared_buffer();
+    render_screen_rows((uint8_t) (page * SSD1306_PAGE_HEIGHT));
+    memcpy(expect, gfx_get_shared_buffer(), sizeof(expect));
+    panel_page(page, actual);
+    snprintf(msg, sizeof(msg), "%s: page %u", what, (unsigned) page);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, actual, SSD1306_WIDTH, msg);
+  }
+}
+
+static void apply(const char* json, uint8_t flags)
+{
+  TEST_ASSERT_EQUAL_INT(RES_OK, protocol_apply_json_object(json, (uint8_t) strlen(json), flags));
+}
+
+/** Build one screen holding only a full-width list, then focus the list. */
+static void build_list_screen(uint8_t height, uint8_t y, uint8_t rows)
+{
+  char obj[48];
+  memset(&g_panel, 0, sizeof(g_panel));
+  TEST_ASSERT_EQUAL_INT(RES_OK, ssd1306_init());
+  TEST_ASSERT_EQUAL_INT(RES_OK, ssd1306_set_height(height));
+  ssd1306_render_async_set_frame_callback(render_frame_begin);
+  snprintf(obj, sizeof(obj), "{\"t\":\"h\",\"n\":%u}", (unsigned) (LIST_ITEMS + 2u));
+  apply(obj, JSON_FLAG_HEAD);
+  apply("{\"t\":\"s\"}", 0u);
+  snprintf(obj, sizeof(obj), "{\"t\":\"l\",\"x\":0,\"y\":%u,\"r\":%u,\"p\":0}",
+           (unsigned) y, (unsigned) rows);
+  apply(obj, 0u);
+  for (uint8_t i = 0; i < LIST_ITEMS; i++) {
+    snprintf(obj, sizeof(obj), "{\"t\":\"t\",\"x\":8,\"tx\":\"Item %02u\",\"p\":1}", (unsigned) i);
+    apply(obj, (i + 1u == LIST_ITEMS) ? JSON_FLAG_COMMIT : 0u);
+  }
+  protocol_set_focus(1u);
+  protocol_request_render();
+  pump_frames();
+  assert_panel_matches_software("initial frame");
+}
+
+/**
+ * Press a button and run animation ticks until the list settles, checking every step.
+ * The row scroll must finish on wall-clock time whatever the tick spacing.
+ */
+static void press_and_check(uint8_t button, uint8_t* used_start_line)
+{
+  uint32_t pressed_ms = g_now_ms;
+  uint8_t payload[2] = {button, 0u};
+  TEST_ASSERT_EQUAL_INT(RES_OK, cmd_input_event(payload, 2u));
+  pump_frames();
+  assert_panel_matches_software("cursor move");
+  for (uint8_t tick = 0; tick < 32u; tick++) {
+    uint8_t line_before = g_panel.start_line;
+    g_now_ms += g_tick_ms;
+    g_pages_built = 0u;
+    protocol_tick_animations();
+    uint8_t mid_scroll = ur_list_find(&g_protocol_state.runtime, 1u)->anim_active;
+    pump_frames();
+    assert_panel_matches_software("scroll step");
+    if ((uint32_t) (g_now_ms - pressed_ms) >= LIST_ANIM_DURATION_MS) {
+      TEST_ASSERT_FALSE_MESSAGE(mid_scroll, "row scroll outlasted LIST_ANIM_DURATION_MS");
+    }
+    if (g_panel.start_line == line_before) {
+      continue;
+    }
+    *used_start_line = 1u;
+    /* At most three row bands, each spread over two GDDRAM pages when unaligned.
+       The last step also redraws the list to drop the old cursor marker. */
+    if (mid_scroll && g_pages_built > 6u) {
+      TEST_FAIL_MESSAGE("start-line step rebuilt more than the exposed row bands");
+    }
+  }
+}
+
+static void run_scroll_sequence(uint8_t height, uint8_t y, uint8_t rows)
+{
+  uint8_t used = 0u;
+  if (g_tick_ms == 0u) {
+    g_tick_ms = PROTOCOL_ANIM_FRAME_MS;
+  }
+  build_list_screen(height, y, rows);
+  /* Walk past the bottom of the window, then back past the top */
+  for (uint8_t i = 0; i < LIST_ITEMS; i++) {
+    press_and_check(UI_BUTTON_DOWN, &used);
+  }
+  for (uint8_t i = 0; i < LIST_ITEMS; i++) {
+    press_and_check(UI_BUTTON_UP, &used);
+  }
+  TEST_ASSERT_TRUE_MESSAGE(used, "list never scrolled through the start line");
+  TEST_ASSERT_EQUAL_UINT8(0u, g_panel.start_line);
+}
+
+/** Every rebuilt page reaches the panel as one transaction with its address window. */
+static void test_page_stream_one_transaction_per_page(void)
+{
+  build_list_screen(64u, 0u, 6u);
+  ssd1306_clear();
+  g_pages_built = 0u;
+  g_data_xfers  = 0u;
+  protocol_request_render();
+  pump_frames();
+  assert_panel_matches_software("after clear");
+  TEST_ASSERT_EQUAL_UINT8(8u, g_pages_built);
+#if SSD1306_STREAM_SINGLE_XFER
+  TEST_ASSERT_EQUAL_UINT8(g_pages_built, g_data_xfers);
+#endif
+}
+
+/** With two tile buffers every page after the first is built while its predecessor streams. */
+static void test_tile_build_overlaps_stream(void)
+{
+  build_list_screen(64u, 0u, 6u);
+  ssd1306_clear();
+  g_pages_built       = 0u;
+  g_overlapped_builds = 0u;
+  protocol_request_render();
+  pump_frames();
+  assert_panel_matches_software("double buffer");
+#if GFX_TILE_BUFFERS > 1
+  TEST_ASSERT_EQUAL_UINT8(g_pages_built - 1u, g_overlapped_builds);
+#else
+  TEST_ASSERT_EQUAL_UINT8(0u, g_overlapped_builds);
+#endif
+}
+
+/** The completion interrupt chains chunks and launches pages built ahead by itself. */
+static void test_interrupt_launches_transfers(void)
+{
+  build_list_screen(64u, 0u, 6u);
+  ssd1306_clear();
+  g_irq_xfers = 0u;
+  protocol_request_render();
+  pump_frames();
+  assert_panel_matches_software("interrupt launches");
+#if SSD1306_XFER_IRQ_CHAIN && (!SSD1306_STREAM_SINGLE_XFER || GFX_TILE_BUFFERS > 1)
+  TEST_ASSERT_TRUE(g_irq_xfers > 0u);
+#else
+  TEST_ASSERT_EQUAL_UINT8(0u, g_irq_xfers);
+#endif
+}
+
+/** A DMA transfer error ends the page and drops the checksums, so the next frame resends it. */
+static void test_transfer_error_resends_page(void)
+{
+  uint8_t payload[2] = {UI_BUTTON_DOWN, 0u};
+  build_list_screen(64u, 0u, 6u);
+  g_tx_fail = 1u;
+  TEST_ASSERT_EQUAL_INT(RES_OK, cmd_input_event(payload, 2u));
+  pump_frames();
+  TEST_ASSERT_EQUAL_UINT8(0u, g_tx_fail);
+  protocol_request_render();
+  pump_frames();
+  assert_panel_matches_software("after transfer error");
+}
+
+/** A transfer whose completion interrupt fires before the launch returns still ends the page. */
+static void test_completion_before_launch_returns(void)
+{
+  build_list_screen(64u, 0u, 6u);
+  ssd1306_clear();
+  g_tx_instant = 1u;
+  protocol_request_render();
+  pump_frames();
+  g_tx_instant = 0u;
+  assert_panel_matches_software("instant completion");
+}
+
+/** Page callback that paints g_pattern_col as a fully lit column on every page. */
+static uint8_t g_pattern_col;
+
+static void pattern_tile(uint8_t tile_y)
+{
+  (void) tile_y;
+  gfx_clear_shared_buffer();
+  if (g_pattern_col < SSD1306_WIDTH) {
+    gfx_get_shared_buffer()[g_pattern_col] = 0xFFu;
+  }
+}
+
+/** Run one full frame of pattern_tile and check every panel page against it. */
+static void draw_pattern(uint8_t col)
+{
+  uint8_t expect[SSD1306_WIDTH];
+  uint8_t actual[SSD1306_WIDTH];
+  g_pattern_col = col;
+  TEST_ASSERT_EQUAL_INT(RES_OK, ssd1306_render_async_begin(pattern_tile));
+  for (int guard = 0; guard < 100000 && ssd1306_render_async_busy(); guard++) {
+    ssd1306_render_async_process();
+  }
+  TEST_ASSERT_FALSE(ssd1306_render_async_busy());
+  memset(expect, 0, sizeof(expect));
+  if (col < SSD1306_WIDTH) {
+    expect[col] = 0xFFu;
+  }
+  for (uint8_t page = 0; page < ssd1306_pages(); page++) {
+    panel_page(page, actual);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expect, actual, SSD1306_WIDTH, "pattern page");
+  }
+}
+
+/** A segment whose only change is a column flipping between 0x00 and 0xFF is resent. */
+static void test_segment_checksum_sees_blank_to_lit_flip(void)
+{
+  memset(&g_panel, 0, sizeof(g_panel));
+  TEST_ASSERT_EQUAL_INT(RES_OK, ssd1306_init());
+  ssd1306_render_async_set_frame_callback(NULL);
+  draw_pattern(SSD1306_WIDTH);
+  draw_pattern(5u);
+  draw_pattern(SSD1306_WIDTH);
+  draw_pattern(SSD1306_WIDTH - 1u);
+}
+
+void setUp(void)
+{
+  g_tick_ms = 0u;
+}
+
+void tearDown(void) {}
+
+static void test_start_line_scroll_matches_software_64(void)
+{
+  run_scroll_sequence(64u, 0u, 6u);
+}
+
+static void test_start_line_scroll_matches_software_32(void)
+{
+  run_scroll_sequence(32u, 0u, 4u);
+}
+
+static void test_start_line_scroll_inset_list_32(void)
+{
+  run_scroll_sequence(32u, 8u, 2u);
+}
+
+/** Frames slower than the animation rate skip positions instead of slowing the scroll. */
+static void test_start_line_scroll_slow_frames_64(void)
+{
+  g_tick_ms = (uint16_t) (PROTOCOL_ANIM_FRAME_MS * 3u);
+  run_scroll_sequence(64u, 0u, 6u);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_start_line_scroll_matches_software_64);
+  RUN_TEST(test_start_line_scroll_matches_software_32);
+  RUN_TEST(test_start_line_scroll_inset_list_32);
+  RUN_TEST(test_start_line_scroll_slow_frames_64);
+  RUN_TEST(test_page_stream_one_transaction_per_page);
+  RUN_TEST(test_tile_build_overlaps_stream);
+  RUN_TEST(test_interrupt_launches_transfers);
+  RUN_TEST(test_transfer_error_resends_page);
+  RUN_TEST(test_completion_before_launch_returns);
+  RUN_TEST(test_segment_checksum_sees_blank_to_lit_flip);
+  return UNITY_END();
+}
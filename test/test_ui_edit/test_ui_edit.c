@@ -0,0 +1,496 @@
+/**
+ * @file test_ui_edit.c
+ * @brief Native test: post-COMMIT structural edits against fresh provisioning.
+ *
+ * Each case provisions a UI, edits it after COMMIT (append a child, remove a subtree,
+ * resize a text) and compares the result with a fresh provisioning of the edited UI:
+ * per-element tables, text attributes, runtime nodes, list row tables and arena use.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "ssd1306_driver.h"
+#include "status_codes.h"
+#include "ui_edit.h"
+#include "ui_focus.h"
+#include "ui_protocol.h"
+#include "ui_runtime.h"
+#include "ui_tree.h"
+
+#define UI_CAPACITY 16u
+#define TEXT_MAX 21u
+#define ROWS_MAX 8u
+
+/** Everything a fresh provisioning determines, per element id. */
+typedef struct {
+  uint8_t   count, screen_count, trigger_count, preorder;
+  uint16_t  head_used, used_tail;
+  element_t elements[UI_CAPACITY];
+  uint8_t   pos_x[UI_CAPACITY], pos_y[UI_CAPACITY];
+  uint8_t   first_child[UI_CAPACITY], next_sibling[UI_CAPACITY];
+  uint8_t   screen_ords[UI_CAPACITY];
+  uint8_t   screen_ids[UI_MAX_SCREENS];
+  uint8_t   root_screen[UI_CAPACITY], top_screen[UI_CAPACITY];
+  uint8_t   subtree_end[UI_CAPACITY];
+  uint8_t   visible[UI_CAPACITY];
+  char      text[UI_CAPACITY][TEXT_MAX];
+  uint8_t   text_len[UI_CAPACITY]; /* entry len byte: size and static flag, 0 = no text */
+  uint8_t   node[UI_CAPACITY];     /* runtime node type found for the id (element type, 0xFF none) */
+  uint8_t   list[UI_CAPACITY][8];  /* cursor, top, rows, last text, row count, pending, anim */
+  uint8_t   rows[UI_CAPACITY][ROWS_MAX];
+  int16_t   barrel_value[UI_CAPACITY];
+  uint8_t   barrel_aux[UI_CAPACITY];
+  uint8_t   trigger_version[UI_CAPACITY];
+} ui_snapshot_t;
+
+static uint32_t g_now_ms;
+
+/* ---- Hardware and platform stubs ---- */
+
+uint32_t get_system_time_ms(void)
+{
+  return g_now_ms;
+}
+
+void debug_log_event(uint8_t type, uint8_t value)
+{
+  (void) type;
+  (void) value;
+}
+
+void debug_led_process(void) {}
+
+void spi_slave_tx_dma_start(const uint8_t* buffer, uint16_t length)
+{
+  (void) buffer;
+  (void) length;
+}
+
+int spi_slave_tx_dma_is_complete(void)
+{
+  return 1;
+}
+
+i2c_err_t i2c_init(i2c_device_t* dev)
+{
+  (void) dev;
+  return I2C_OK;
+}
+
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status))
+{
+  (void) callback;
+}
+
+int i2c_tx_dma_busy(void)
+{
+  return 0;
+}
+
+i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len)
+{
+  (void) dev;
+  (void) buf;
+  (void) len;
+  return I2C_OK;
+}
+
+/* ---- UI fixture ---- */
+
+#if UI_STRUCT_EDIT
+
+#define NO_PARENT 0xFFu
+
+/** One provisioning object: JSON without the closing brace, parent as an index in its list. */
+typedef struct {
+  const char* obj;
+  uint8_t     parent;
+} ui_obj_t;
+
+/**
+ * Base UI, ids in creation order:
+ *  0 screen      1 text "Title"   2 list (3 rows)  3..5 rows "Alpha" "Bravo" "Charlie"
+ *  6 barrel      7..8 options     9 trigger
+ * 10 overlay    11 text "Saved"  12 trigger
+ * 13 screen     14 text "Two"
+ */
+static const ui_obj_t k_base[] = {
+  {"{\"t\":\"s\"", NO_PARENT},
+  {"{\"t\":\"t\",\"x\":0,\"y\":0,\"tx\":\"Title\"", 0u},
+  {"{\"t\":\"l\",\"x\":0,\"y\":8,\"r\":3", 0u},
+  {"{\"t\":\"t\",\"x\":8,\"tx\":\"Alpha\",\"c\":8", 2u},
+  {"{\"t\":\"t\",\"x\":8,\"tx\":\"Bravo\"", 2u},
+  {"{\"t\":\"t\",\"x\":8,\"tx\":\"Charlie\"", 2u},
+  {"{\"t\":\"b\",\"x\":0,\"y\":40,\"v\":1", 0u},
+  {"{\"t\":\"t\",\"x\":8,\"tx\":\"AUTO\"", 6u},
+  {"{\"t\":\"t\",\"x\":8,\"tx\":\"ECO\"", 6u},
+  {"{\"t\":\"i\",\"x\":0,\"y\":48", 0u},
+  {"{\"t\":\"s\",\"ov\":1", NO_PARENT},
+  {"{\"t\":\"t\",\"x\":0,\"y\":0,\"tx\":\"Saved\"", 10u},
+  {"{\"t\":\"i\",\"x\":0,\"y\":8", 10u},
+  {"{\"t\":\"s\"", NO_PARENT},
+  {"{\"t\":\"t\",\"x\":0,\"y\":0,\"tx\":\"Two\"", 13u},
+};
+#define BASE_COUNT ((uint8_t) (sizeof(k_base) / sizeof(k_base[0])))
+
+static void apply(const char* json, uint8_t flags)
+{
+  TEST_ASSERT_EQUAL_INT_MESSAGE(RES_OK,
+                                protocol_apply_json_object(json, (uint8_t) strlen(json), flags),
+                                json);
+}
+
+/** Send one object to the live UI (an append after COMMIT). */
+static void apply_obj(const ui_obj_t* o, uint8_t flags)
+{
+  char json[64];
+  if (o->parent == NO_PARENT) {
+    snprintf(json, sizeof(json), "%s}", o->obj);
+  } else {
+    snprintf(json, sizeof(json), "%s,\"p\":%u}", o->obj, (unsigned) o->parent);
+  }
+  apply(json, flags);
+}
+
+/** Provision a UI from scratch; COMMIT goes with the last object. */
+static void provision(const ui_obj_t* objs, uint8_t count)
+{
+  char head[24];
+  protocol_reset_state();
+  snprintf(head, sizeof(head), "{\"t\":\"h\",\"n\":%u}", (unsigned) UI_CAPACITY);
+  apply(head, JSON_FLAG_HEAD);
+  for (uint8_t i = 0; i < count; i++) {
+    apply_obj(&objs[i], (i + 1u == count) ? JSON_FLAG_COMMIT : 0u);
+  }
+}
+
+static void provision_base(void)
+{
+  provision(k_base, BASE_COUNT);
+}
+
+static void snapshot(ui_snapshot_t* s)
+{
+  protocol_state_t* st = &g_protocol_state;
+  ui_runtime_t*     rt = &st->runtime;
+  memset(s, 0, sizeof(*s));
+  memset(s->elements, 0xFF, sizeof(s->elements));
+  s->count         = st->element_count;
+  s->screen_count  = st->screen_count;
+  s->trigger_count = st->trigger_count;
+  s->preorder      = st->preorder;
+  s->head_used     = rt->head_used;
+  s->used_tail     = rt->used_tail;
+  for (uint8_t o = 0; o < st->screen_count; o++) {
+    s->screen_ids[o] = find_screen_id_by_ordinal(o);
+  }
+  for (uint8_t i = 0; i < st->element_count && i < UI_CAPACITY; i++) {
+    s->elements[i]     = st->elements[i];
+    s->pos_x[i]        = st->pos_x[i];
+    s->pos_y[i]        = st->pos_y[i];
+    s->first_child[i]  = st->first_child[i];
+    s->next_sibling[i] = st->next_sibling[i];
+    s->screen_ords[i]  = st->screen_ords[i];
+    s->root_screen[i]  = element_root_screen(i);
+    s->top_screen[i]   = element_top_screen(i);
+    s->subtree_end[i]  = element_subtree_end(i);
+    s->visible[i]      = protocol_is_element_visible(i);
+    const char* text   = ui_attr_get_text(rt, i);
+    if (text != NULL) {
+      const ui_attr_text_entry_t* e =
+        (const ui_attr_text_entry_t*) (const void*) (text - UI_ATTR_SIZE_TEXT_HDR);
+      strncpy(s->text[i], text, TEXT_MAX - 1u);
+      s->text_len[i] = e->len;
+    }
+    s->node[i]               = 0xFFu;
+    ur_list_state_t*    ls = ur_list_find(rt, i);
+    ur_barrel_state_t*  bs = ur_barrel_find(rt, i);
+    ur_trigger_state_t* ts = ur_trigger_find(rt, i);
+    if (ls != NULL) {
+      uint8_t        n   = 0u;
+      const uint8_t* row = list_row_table(i, &n);
+      s->node[i]    = ELEMENT_LIST_VIEW;
+      s->list[i][0] = ls->cursor;
+      s->list[i][1] = ls->top_index;
+      s->list[i][2] = ls->visible_rows;
+      s->list[i][3] = ls->last_text_child;
+      s->list[i][4] = ls->row_count;
+      s->list[i][5] = ls->pending_cursor;
+      s->list[i][6] = ls->pending_top;
+      s->list[i][7] = ls->anim_active;
+      TEST_ASSERT_NOT_NULL_MESSAGE(row, "list has no row table");
+      TEST_ASSERT_TRUE(n <= ROWS_MAX);
+      memcpy(s->rows[i], row, n);
+    } else if (bs != NULL) {
+      s->node[i]         = ELEMENT_BARREL;
+      s->barrel_value[i] = bs->value;
+      s->barrel_aux[i]   = bs->aux;
+    } else if (ts != NULL) {
+      s->node[i]            = ELEMENT_TRIGGER;
+      s->trigger_version[i] = ts->version;
+    }
+  }
+}
+
+/** Nearest SCREEN of eid (self included) or its parentless top, found by walking parent ids. */
+static uint8_t walk_screen(uint8_t eid, uint8_t top)
+{
+  protocol_state_t* st    = &g_protocol_state;
+  uint8_t           found = INVALID_ELEMENT_ID;
+  while (eid < st->element_count) {
+    if (st->elements[eid].type == ELEMENT_SCREEN) {
+      found = eid;
+      if (!top) {
+        break;
+      }
+    } else if (top) {
+      found = INVALID_ELEMENT_ID;
+    }
+    eid = st->elements[eid].parent_id;
+  }
+  return found;
+}
+
+/** Whether ancestor is eid itself or one of its parents, found by walking parent ids. */
+static uint8_t walk_within(uint8_t eid, uint8_t ancestor)
+{
+  while (eid < g_protocol_state.element_count) {
+    if (eid == ancestor) {
+      return 1u;
+    }
+    eid = g_protocol_state.elements[eid].parent_id;
+  }
+  return 0u;
+}
+
+/** One past the last descendant of eid in a pre-order UI, found without the subtree index. */
+static uint8_t walk_subtree_end(uint8_t eid)
+{
+  uint8_t end = (uint8_t) (eid + 1u);
+  while (end < g_protocol_state.element_count && walk_within(end, eid)) {
+    end++;
+  }
+  return end;
+}
+
+/** The current (edited) UI must match a fresh provisioning snapshot. */
+static void assert_matches(const ui_snapshot_t* want)
+{
+  ui_snapshot_t got;
+  char          msg[48];
+  snapshot(&got);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->count, got.count, "element count");
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->screen_count, got.screen_count, "screen count");
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->trigger_count, got.trigger_count, "trigger count");
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->preorder, got.preorder, "preorder");
+  TEST_ASSERT_EQUAL_UINT16_MESSAGE(want->head_used, got.head_used, "arena head");
+  TEST_ASSERT_EQUAL_UINT16_MESSAGE(want->used_tail, got.used_tail, "arena tail");
+  TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(want->screen_ids, got.screen_ids, want->screen_count,
+                                        "screen ids");
+  for (uint8_t i = 0; i < want->count; i++) {
+    snprintf(msg, sizeof(msg), "element %u", (unsigned) i);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->elements[i].parent_id, got.elements[i].parent_id, msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->elements[i].type, got.elements[i].type, msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->pos_x[i], got.pos_x[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->pos_y[i], got.pos_y[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->first_child[i], got.first_child[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->next_sibling[i], got.next_sibling[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->screen_ords[i], got.screen_ords[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->root_screen[i], got.root_screen[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->top_screen[i], got.top_screen[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(walk_screen(i, 0u), got.root_screen[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(walk_screen(i, 1u), got.top_screen[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->subtree_end[i], got.subtree_end[i], msg);
+    if (got.preorder) {
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(walk_subtree_end(i), got.subtree_end[i], msg);
+    }
+    for (uint8_t j = 0; j < want->count; j++) {
+      TEST_ASSERT_EQUAL_UINT8_MESSAGE(walk_within(j, i), is_descendant_of(j, i), msg);
+    }
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->visible[i], got.visible[i], msg);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(want->text[i], got.text[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->text_len[i], got.text_len[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->node[i], got.node[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(want->list[i], got.list[i], 8u, msg);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(want->rows[i], got.rows[i], ROWS_MAX, msg);
+    TEST_ASSERT_EQUAL_INT16_MESSAGE(want->barrel_value[i], got.barrel_value[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->barrel_aux[i], got.barrel_aux[i], msg);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(want->trigger_version[i], got.trigger_version[i], msg);
+  }
+}
+
+
+/** Snapshot a fresh provisioning of the base UI with obj created as id at. */
+static void expected_with(ui_snapshot_t* want, uint8_t at, const ui_obj_t* obj)
+{
+  ui_obj_t objs[UI_CAPACITY];
+  uint8_t  n = 0u;
+  for (uint8_t i = 0; i < BASE_COUNT; i++) {
+    if (i == at) {
+      objs[n++] = *obj;
+    }
+    objs[n] = k_base[i];
+    if (objs[n].parent != NO_PARENT && objs[n].parent >= at) {
+      objs[n].parent++;
+    }
+    n++;
+  }
+  provision(objs, n);
+  snapshot(want);
+}
+
+/** Snapshot a fresh provisioning of the base UI without the ids in [first, end). */
+static void expected_without(ui_snapshot_t* want, uint8_t first, uint8_t end)
+{
+  ui_obj_t objs[UI_CAPACITY];
+  uint8_t  n = 0u;
+  for (uint8_t i = 0; i < BASE_COUNT; i++) {
+    if (i >= first && i < end) {
+      continue;
+    }
+    objs[n] = k_base[i];
+    if (objs[n].parent != NO_PARENT && objs[n].parent >= end) {
+      objs[n].parent = (uint8_t) (objs[n].parent - (end - first));
+    }
+    n++;
+  }
+  provision(objs, n);
+  snapshot(want);
+}
+
+static void remove_subtree(uint8_t eid)
+{
+  char obj[24];
+  snprintf(obj, sizeof(obj), "{\"t\":\"r\",\"e\":%u}", (unsigned) eid);
+  apply(obj, 0u);
+}
+
+/* ---- Cases ---- */
+
+/** A list row appended after COMMIT lands after the last row, shifting later ids. */
+static void test_append_list_row_matches_fresh(void)
+{
+  static const ui_obj_t row = {"{\"t\":\"t\",\"x\":8,\"tx\":\"Delta\"", 2u};
+  ui_snapshot_t         want;
+  expected_with(&want, 6u, &row);
+  provision_base();
+  apply_obj(&row, 0u);
+  assert_matches(&want);
+}
+
+/** An appended screen child joins the end of the screen's id range. */
+static void test_append_screen_child_matches_fresh(void)
+{
+  static const ui_obj_t text = {"{\"t\":\"t\",\"x\":0,\"y\":56,\"tx\":\"Foot\"", 0u};
+  ui_snapshot_t         want;
+  expected_with(&want, 10u, &text);
+  provision_base();
+  apply_obj(&text, 0u);
+  assert_matches(&want);
+}
+
+/** Removing a barrel takes its options with it. */
+static void test_remove_subtree_matches_fresh(void)
+{
+  ui_snapshot_t want;
+  expected_without(&want, 6u, 9u);
+  provision_base();
+  remove_subtree(6u);
+  assert_matches(&want);
+}
+
+/** Removing the selected row of the focused list keeps focus and clamps the cursor. */
+static void test_remove_row_under_focused_list(void)
+{
+  ui_snapshot_t    want;
+  ur_list_state_t* ls;
+  expected_without(&want, 5u, 6u);
+  want.list[2][0] = 1u; /* cursor clamped to the new last row */
+  want.list[2][5] = 1u;
+  provision_base();
+  protocol_set_focus(2u);
+  ls                 = ur_list_find(&g_protocol_state.runtime, 2u);
+  ls->cursor         = 2u;
+  ls->pending_cursor = 2u;
+  remove_subtree(5u);
+  TEST_ASSERT_EQUAL_UINT8(2u, g_protocol_state.focused_element);
+  assert_matches(&want);
+}
+
+/** Edits under a shown overlay keep it up; removing the overlay itself clears it. */
+static void test_remove_under_and_of_overlay(void)
+{
+  uint8_t       sid = 10u;
+  ui_snapshot_t want;
+  expected_without(&want, 11u, 12u);
+  provision_base();
+  TEST_ASSERT_EQUAL_INT(RES_OK, cmd_show_overlay(&sid, 1u));
+  remove_subtree(11u);
+  TEST_ASSERT_EQUAL_UINT8(10u, g_protocol_state.overlay.active_overlay_screen_id);
+  assert_matches(&want);
+
+  expected_without(&want, 10u, 13u);
+  provision_base();
+  TEST_ASSERT_EQUAL_INT(RES_OK, cmd_show_overlay(&sid, 1u));
+  remove_subtree(10u);
+  TEST_ASSERT_EQUAL_UINT8(INVALID_ELEMENT_ID, g_protocol_state.overlay.active_overlay_screen_id);
+  assert_matches(&want);
+}
+
+/** A text resized after COMMIT equals one created with that capacity. */
+static void test_resize_text_matches_fresh(void)
+{
+  ui_obj_t      objs[BASE_COUNT];
+  ui_snapshot_t want;
+  memcpy(objs, k_base, sizeof(objs));
+  objs[4].obj = "{\"t\":\"t\",\"x\":8,\"tx\":\"Bee\",\"c\":12";
+  provision(objs, BASE_COUNT);
+  snapshot(&want);
+  provision_base();
+  apply("{\"e\":4,\"tx\":\"Bee\",\"c\":12}", 0u);
+  assert_matches(&want);
+}
+
+/** Without contiguous subtrees a removal is refused and leaves the UI untouched. */
+static void test_remove_refused_without_preorder(void)
+{
+  static const ui_obj_t    objs[] = {
+    {"{\"t\":\"s\"", NO_PARENT},
+    {"{\"t\":\"s\"", NO_PARENT},
+    {"{\"t\":\"t\",\"x\":0,\"y\":0,\"tx\":\"Late\"", 0u},
+  };
+  static const char* const remove = "{\"t\":\"r\",\"e\":0}";
+  ui_snapshot_t            before;
+  provision(objs, 3u);
+  TEST_ASSERT_EQUAL_UINT8(0u, g_protocol_state.preorder);
+  snapshot(&before);
+  TEST_ASSERT_EQUAL_INT(RES_BAD_STATE,
+                        protocol_apply_json_object(remove, (uint8_t) strlen(remove), 0u));
+  TEST_ASSERT_EQUAL_INT(RES_BAD_STATE, ui_edit_remove_subtree(2u));
+  assert_matches(&before);
+}
+
+#endif /* UI_STRUCT_EDIT */
+
+void setUp(void)
+{
+  g_now_ms = 1000u;
+}
+
+void tearDown(void) {}
+
+int main(void)
+{
+  UNITY_BEGIN();
+#if UI_STRUCT_EDIT
+  RUN_TEST(test_append_list_row_matches_fresh);
+  RUN_TEST(test_append_screen_child_matches_fresh);
+  RUN_TEST(test_remove_subtree_matches_fresh);
+  RUN_TEST(test_remove_row_under_focused_list);
+  RUN_TEST(test_remove_under_and_of_overlay);
+  RUN_TEST(test_resize_text_matches_fresh);
+  RUN_TEST(test_remove_refused_without_preorder);
+#endif
+  return UNITY_END();
+}
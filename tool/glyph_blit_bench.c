@@ -0,0 +1,152 @@
+/**
+ * @file glyph_blit_bench.c
+ * @brief Host benchmark: per-bit text drawing vs. gfx_draw_text_clipped().
+ *
+ * Build and run from the repository root:
+ *   cc -O2 -Iinclude/slave -Iinclude/common tool/glyph_blit_bench.c src/slave/gfx_shared.c \
+ *      src/slave/font_5x8.c -o /tmp/glyph_blit_bench && /tmp/glyph_blit_bench
+ *
+ * Both paths draw the same label at every y offset across a page boundary and the
+ * outputs are compared byte for byte before timing. Cycles come from the TSC on x86
+ * hosts; other hosts report nanoseconds.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "gfx_shared.h"
+
+#define BENCH_ROUNDS 20000u
+
+static const char k_label[] = "Volume: 42 dB";
+
+/** Per-bit reference (the renderer's draw path before the word-level blitter). */
+static void draw_text_per_bit(int16_t     x,
+                              int16_t     pixel_y,
+                              const char* text,
+                              uint8_t     viewport_top,
+                              uint8_t     viewport_bottom,
+                              uint8_t     page_top)
+{
+  if (pixel_y > viewport_bottom || (pixel_y + 7) < viewport_top) {
+    return;
+  }
+  if (pixel_y > (int16_t) (page_top + 7) || (pixel_y + 7) < page_top) {
+    return;
+  }
+  uint8_t* buf = gfx_get_shared_buffer();
+  int16_t  cx  = x;
+  while (*text && cx < (int16_t) GFX_TILE_WIDTH) {
+    uint8_t ch = (uint8_t) *text;
+    if (ch < GFX_FONT_FIRST_CHAR || ch > GFX_FONT_LAST_CHAR) {
+      ch = GFX_FONT_FIRST_CHAR;
+    }
+    const uint8_t* glyph = GFX_FONT_DATA[ch - GFX_FONT_FIRST_CHAR];
+    for (uint8_t col = 0; col < GFX_FONT_CHAR_WIDTH && cx < (int16_t) GFX_TILE_WIDTH; col++) {
+      uint8_t col_bits = glyph[col];
+      if (col_bits) {
+        uint8_t out_bits = 0;
+        for (uint8_t b = 0; b < 8; b++) {
+          if (!(col_bits & (1u << b))) {
+            continue;
+          }
+          int16_t gy = pixel_y + b;
+          if (gy < viewport_top || gy > viewport_bottom) {
+            continue;
+          }
+          if (gy < page_top || gy > (int16_t) (page_top + 7)) {
+            continue;
+          }
+          out_bits |= (uint8_t) (1u << (gy - page_top));
+        }
+        if (cx >= 0) {
+          buf[(uint8_t) cx] |= out_bits;
+        }
+      }
+      cx++;
+    }
+    if (cx < (int16_t) GFX_TILE_WIDTH) {
+      cx++;
+    }
+    text++;
+  }
+}
+
+typedef void (*draw_fn_t)(int16_t, int16_t, const char*, uint8_t, uint8_t, uint8_t);
+
+static uint64_t bench_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+/** Compare both paths over x/y/clip combinations; return mismatch count. */
+static unsigned check_equivalence(void)
+{
+  uint8_t  ref[GFX_TILE_WIDTH];
+  unsigned mismatches = 0u;
+  for (int16_t x = -40; x <= 130; x += 3) {
+    for (int16_t y = 0; y <= 23; y++) {
+      for (uint8_t clip = 0; clip < 3; clip++) {
+        uint8_t top    = (clip == 1) ? 10u : 0u;
+        uint8_t bottom = (clip == 2) ? 12u : 63u;
+        gfx_clear_shared_buffer();
+        draw_text_per_bit(x, y, k_label, top, bottom, 8u);
+        memcpy(ref, gfx_get_shared_buffer(), sizeof(ref));
+        gfx_clear_shared_buffer();
+        gfx_draw_text_clipped(x, y, k_label, top, bottom, 8u);
+        if (memcmp(ref, gfx_get_shared_buffer(), sizeof(ref)) != 0) {
+          mismatches++;
+        }
+      }
+    }
+  }
+  return mismatches;
+}
+
+/** Return average ticks per character for one draw path. */
+static double bench_path(draw_fn_t fn, uint8_t aligned_only)
+{
+  uint64_t chars = 0u;
+  uint64_t start = bench_now();
+  for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+    for (int16_t y = 1; y <= 15; y++) {
+      int16_t pixel_y = aligned_only ? 8 : y;
+      fn(4, pixel_y, k_label, 0u, 63u, 8u);
+      chars += sizeof(k_label) - 1u;
+    }
+  }
+  uint64_t end = bench_now();
+  return (double) (end - start) / (double) chars;
+}
+
+int main(void)
+{
+  unsigned mismatches = check_equivalence();
+  if (mismatches != 0u) {
+    printf("FAIL: %u mismatching tiles\n", mismatches);
+    return 1;
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  const char* unit = "cycles";
+#else
+  const char* unit = "ns";
+#endif
+  printf("unaligned y: per-bit %.1f %s/char, word %.1f %s/char\n",
+         bench_path(draw_text_per_bit, 0u),
+         unit,
+         bench_path(gfx_draw_text_clipped, 0u),
+         unit);
+  printf("page-aligned y: per-bit %.1f %s/char, word %.1f %s/char\n",
+         bench_path(draw_text_per_bit, 1u),
+         unit,
+         bench_path(gfx_draw_text_clipped, 1u),
+         unit);
+  return 0;
+}
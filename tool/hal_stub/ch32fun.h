@@ -13,9 +13,26 @@ typedef struct {
   uint32_t DATAR;
 } spi_stub_t;
 
-static spi_stub_t spi1_stub;
+/* Unused in most translation units that include the stub */
+static __attribute__((unused)) spi_stub_t spi1_stub;
 
 #define SPI1 (&spi1_stub)
 #define SPI_STATR_OVR (1u << 6)
 
+typedef struct {
+  uint32_t CTLR;
+  uint32_t SR;
+  uint32_t CNT;
+  uint32_t CMP;
+} systick_stub_t;
+
+static __attribute__((unused)) systick_stub_t systick_stub;
+
+#define SysTick (&systick_stub)
+#define DELAY_US_TIME 1u
+#define DELAY_MS_TIME 1000u
+
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
 #endif /* CH32FUN_H */
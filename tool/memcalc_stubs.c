@@ -33,6 +33,35 @@ uint8_t ssd1306_height(void)
   return (uint8_t)SSD1306_HEIGHT;
 }
 
+void ssd1306_invalidate_region(uint8_t page_first,
+                               uint8_t page_last,
+                               uint8_t col_first,
+                               uint8_t col_last)
+{
+  (void)page_first;
+  (void)page_last;
+  (void)col_first;
+  (void)col_last;
+}
+
+void ssd1306_invalidate_all(void) {}
+
+int ssd1306_render_async_busy(void)
+{
+  return 0;
+}
+
+void ssd1306_scroll_lines(int8_t dy)
+{
+  (void)dy;
+}
+
+uint8_t render_list_owns_panel(uint8_t list_id)
+{
+  (void)list_id;
+  return 0u;
+}
+
 uint32_t get_system_time_ms(void)
 {
   return 0u;
@@ -49,3 +78,9 @@ void gfx_clear_shared_buffer(void)
   uint8_t* buf = gfx_get_shared_buffer();
   (void)memset(buf, 0, 128);
 }
+
+int ssd1306_perf_read(ssd1306_perf_t* out)
+{
+  (void)memset(out, 0, sizeof(*out));
+  return 0;
+}
@@ -25,11 +25,13 @@ Conversion:
 Notes:
 - TEXT capacity `c` is 0..20. Device allocates `c+1` bytes for the text payload including NUL.
 - Input must be nested (elements arrays); flat input is rejected.
-- A header element `{"t":"h","n":<count>}` is always emitted to reserve per-element storage.
+- A header element `{"t":"h","n":<count>}` is always emitted to reserve per-element storage;
+  `--spare N` adds N slots for children appended after COMMIT.
 - Memory usage is validated by executing the real slave parser via a host-built memcalc library.
 
 Usage:
     python nested_to_flat.py input.json > output.json
+    python nested_to_flat.py --spare 4 input.json > output.json
 
 Exit codes: 0 success, 1 error.
 """
@@ -103,8 +105,13 @@ def _memcalc_sources(root):
         root / "src" / "slave" / "ui_runtime.c",
         root / "src" / "slave" / "ui_focus.c",
         root / "src" / "slave" / "ui_input.c",
+        root / "src" / "slave" / "ui_layout.c",
         root / "src" / "slave" / "ui_numeric.c",
+        root / "src" / "slave" / "ui_anim.c",
         root / "src" / "slave" / "ui_tree.c",
+        root / "src" / "slave" / "ui_edit.c",
+        root / "src" / "slave" / "ui_persist.c",
+        root / "src" / "slave" / "flash_store.c",
         root / "src" / "common" / "cobs.c",
     ]
 
@@ -284,9 +291,11 @@ def shorten(elements):
             tx = ne.get('tx', '')
             if not isinstance(tx, str):
                 tx = ''
-            # If input provided long-form capacity/cap, it already mapped to 'c'
+            # If input provided long-form capacity/cap, it already mapped to 'c'.
+            # Without one the text is a static label: c=0 sizes it to the text on the slave,
+            # and a saved UI keeps it in the flash string table instead of RAM.
             if 'c' not in ne:
-                cap = len(tx)
+                cap = 0
             else:
                 # trust provided value but clamp
                 try:
@@ -363,7 +372,7 @@ def validate_and_sanitize(elements, height=32):
             if len(tx) > 20:
                 tx = tx[:20]
             # capacity 'c' (0..20; 0 means auto=tx length)
-            cap = _as_int(e.get('c', len(tx)), len(tx))
+            cap = _as_int(e.get('c', 0), 0)
             cap = _clamp(cap, 0, 20)
             e['c'] = cap
             eff_cap = cap if cap > 0 else len(tx)
@@ -406,8 +415,10 @@ def memcalc_usage(out_elements):
         header = {}
     element_count = len(out_elements) - 1
     header_n = header.get('n')
-    if not isinstance(header_n, int) or header_n != element_count:
-        errs.append(f'header n={header_n} does not match element count {element_count}')
+    if not isinstance(header_n, int) or header_n < element_count:
+        errs.append(f'header n={header_n} is below element count {element_count}')
+    elif header_n > MAX_ELEMENT_ID:
+        errs.append(f'header n={header_n} exceeds {MAX_ELEMENT_ID}')
     if element_count > MAX_ELEMENT_ID:
         errs.append(f'element count {element_count} exceeds {MAX_ELEMENT_ID}')
     if errs:
@@ -463,6 +474,8 @@ def main():
     ap = argparse.ArgumentParser(add_help=True)
     ap.add_argument('input', help='nested (long-key) JSON file')
     ap.add_argument('--height', type=int, default=32, choices=[32,64], help='display height for clamping (32 or 64)')
+    ap.add_argument('--spare', type=int, default=0,
+                    help='extra element slots in the header for post-COMMIT appends')
     # Header is required by the slave; no legacy mode.
     args = ap.parse_args()
     try:
@@ -475,7 +488,9 @@ def main():
     elements = shorten(elements)
     # Validate and sanitize based on device constraints and pruned checks
     validate_and_sanitize(elements, height=args.height)
-    out_elements = [{'t': 'h', 'n': len(elements)}] + elements
+    if args.spare < 0:
+        print('Error: --spare must not be negative', file=sys.stderr); sys.exit(1)
+    out_elements = [{'t': 'h', 'n': len(elements) + args.spare}] + elements
     check_memory_budget(out_elements)
     json.dump({ 'elements': out_elements }, sys.stdout, ensure_ascii=False, separators=(',',':'))
     print()
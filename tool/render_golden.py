@@ -0,0 +1,298 @@
+#!/usr/bin/env python3
+"""
+Render a nested UI JSON through the real slave renderer and SSD1306 driver on the host,
+compare the panel image with golden PBM files and report per-frame cost.
+
+The harness library (tool/render_harness.c plus the slave sources) is built on demand.
+Scenes rendered for each height:
+  initial  first frame after the JSON commit
+  down     DOWN pressed, then the animations it starts run to completion
+  restored the UI saved to flash right after the commit, restored as at boot; must match
+           the initial golden (no golden or cost limit of its own)
+
+The save right after the commit moves static texts to the flash string table, so every scene
+renders them through flash references; the arena bytes it frees are reported.
+
+Goldens:    tool/testdata/<stem>.h<height>.<scene>.pbm (plain P1, one char per pixel)
+Cost limit: tool/testdata/<stem>.frame_cost.json (tile callbacks and I2C bytes per scene)
+
+Checks fail when an image differs, when a scene needs more tile callbacks or I2C bytes
+than the recorded limit, or when the saved UI hash differs from the FNV-1a hash of the
+JSON objects sent (the value a host compares with GET_UI_IMAGE). Host instruction counts (Linux perf counters) are reported only.
+
+Usage:
+    python tool/render_golden.py tool/testdata/ui_sample_nested.json
+    python tool/render_golden.py --update tool/testdata/ui_sample_nested.json
+    python tool/render_golden.py --out /tmp/frames tool/testdata/ui_sample_nested.json
+"""
+import argparse
+import ctypes
+import json
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+PANEL_WIDTH = 128
+PANEL_PAGES = 8
+UI_BUTTON_DOWN = 1
+SCENE_SETTLE_MS = 600
+COST_KEYS = ("tile_calls", "i2c_bytes")
+# Scenes checked against another scene's golden image
+SCENE_GOLDEN = {"restored": "initial"}
+FNV_INIT = 0x811C9DC5
+FNV_PRIME = 16777619
+
+_HARNESS_LIB = None
+
+
+class HarnessStats(ctypes.Structure):
+    _fields_ = [
+        ("tile_calls", ctypes.c_uint32),
+        ("i2c_xfers", ctypes.c_uint32),
+        ("i2c_bytes", ctypes.c_uint32),
+        ("data_bytes", ctypes.c_uint32),
+        ("tile_instr", ctypes.c_int64),
+    ]
+
+
+def _load_converter():
+    root = Path(__file__).resolve().parents[1]
+    sys.path.insert(0, str(root / "tool"))
+    import nested_to_flat as conv  # pylint: disable=import-error
+    return conv
+
+
+def _harness_sources(root):
+    slave = root / "src" / "slave"
+    return [
+        root / "tool" / "render_harness.c",
+        slave / "ui_protocol.c",
+        slave / "ui_runtime.c",
+        slave / "ui_focus.c",
+        slave / "ui_input.c",
+        slave / "ui_layout.c",
+        slave / "ui_numeric.c",
+        slave / "ui_anim.c",
+        slave / "ui_tree.c",
+        slave / "ui_edit.c",
+        slave / "ui_persist.c",
+        slave / "flash_store.c",
+        slave / "ui_renderer.c",
+        slave / "ssd1306_driver.c",
+        slave / "gfx_shared.c",
+        slave / "gfx_raster.c",
+        slave / "font_5x8.c",
+        root / "src" / "common" / "cobs.c",
+    ]
+
+
+def _load_harness(conv):
+    global _HARNESS_LIB
+    if _HARNESS_LIB is not None:
+        return _HARNESS_LIB
+    root = conv._project_root()
+    lib_path = conv._memcalc_lib_path().with_name(
+        "render_harness" + conv._memcalc_lib_path().suffix)
+    sources = _harness_sources(root)
+    if conv._memcalc_needs_rebuild(lib_path, sources, conv._memcalc_headers(root)):
+        cc = os.environ.get("CC", "cc")
+        shared_flags = ["-dynamiclib"] if sys.platform == "darwin" else ["-shared"]
+        cmd = [
+            cc,
+            "-std=gnu99",
+            "-O2",
+            "-fPIC",
+            "-DUNIT_TEST=1",
+            "-I", str(root / "include" / "common"),
+            "-I", str(root / "include" / "slave"),
+            "-I", str(root / "tool" / "hal_stub"),
+            *shared_flags,
+            "-o", str(lib_path),
+            *[str(s) for s in sources],
+        ]
+        try:
+            subprocess.run(cmd, check=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+        except subprocess.CalledProcessError as e:
+            msg = e.stderr.strip() if e.stderr else str(e)
+            raise SystemExit(f"[render] harness build failed: {msg}")
+    lib = ctypes.CDLL(str(lib_path))
+    lib.render_harness_reset.argtypes = [ctypes.c_uint8]
+    lib.render_harness_reset.restype = ctypes.c_int
+    lib.render_harness_apply_object.argtypes = [ctypes.c_char_p, ctypes.c_uint16, ctypes.c_uint8]
+    lib.render_harness_apply_object.restype = ctypes.c_int
+    lib.render_harness_save.argtypes = [ctypes.POINTER(ctypes.c_uint32)]
+    lib.render_harness_save.restype = ctypes.c_int
+    lib.render_harness_restore.argtypes = []
+    lib.render_harness_restore.restype = ctypes.c_int
+    lib.render_harness_arena_used.argtypes = []
+    lib.render_harness_arena_used.restype = ctypes.c_uint16
+    lib.render_harness_input.argtypes = [ctypes.c_uint8]
+    lib.render_harness_input.restype = ctypes.c_int
+    lib.render_harness_run.argtypes = [ctypes.c_uint16, ctypes.POINTER(HarnessStats)]
+    lib.render_harness_run.restype = ctypes.c_int
+    lib.render_harness_framebuffer.argtypes = [ctypes.POINTER(ctypes.c_uint8)]
+    lib.render_harness_framebuffer.restype = None
+    _HARNESS_LIB = lib
+    return lib
+
+
+def _flat_objects(conv, input_path, height):
+    with open(input_path, "r", encoding="utf-8") as f:
+        doc = json.load(f)
+    conv.validate_nested_input(doc)
+    elements = conv.flatten(doc)
+    elements = conv.shorten(elements)
+    conv.validate_and_sanitize(elements, height=height)
+    return [{"t": "h", "n": len(elements)}] + elements
+
+
+def _ui_hash(payloads):
+    """FNV-1a over the JSON object bytes in send order (flags byte excluded)."""
+    h = FNV_INIT
+    for payload in payloads:
+        for b in payload:
+            h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def _check(rc, what):
+    if rc != 0:
+        raise SystemExit(f"[render] {what} returned {rc}")
+
+
+def _framebuffer_rows(lib, height):
+    buf = (ctypes.c_uint8 * (PANEL_WIDTH * PANEL_PAGES))()
+    lib.render_harness_framebuffer(buf)
+    rows = []
+    for y in range(height):
+        base = (y >> 3) * PANEL_WIDTH
+        bit = 1 << (y & 7)
+        rows.append("".join("1" if buf[base + x] & bit else "0" for x in range(PANEL_WIDTH)))
+    return rows
+
+
+def _pbm_text(rows):
+    lines = ["P1", f"{PANEL_WIDTH} {len(rows)}"]
+    for row in rows:
+        # PBM plain lines stay under 70 characters
+        lines.append(row[:64])
+        lines.append(row[64:])
+    return "\n".join(lines) + "\n"
+
+
+def _pbm_rows(text):
+    tokens = [t for line in text.splitlines() if not line.startswith("#") for t in line.split()]
+    if len(tokens) < 3 or tokens[0] != "P1":
+        raise SystemExit("[render] golden is not a plain PBM")
+    width, height = int(tokens[1]), int(tokens[2])
+    bits = "".join(tokens[3:])
+    return [bits[y * width:(y + 1) * width] for y in range(height)]
+
+
+def _render_scenes(conv, lib, input_path, height):
+    """Yield (scene, stats, rows) for every scene at one panel height."""
+    _check(lib.render_harness_reset(height), "render_harness_reset")
+    objects = _flat_objects(conv, input_path, height)
+    payloads = []
+    for idx, obj in enumerate(objects):
+        flags = 0
+        if idx == 0:
+            flags |= conv.JSON_FLAG_HEAD
+        if idx == len(objects) - 1:
+            flags |= conv.JSON_FLAG_COMMIT
+        payload = json.dumps(obj, ensure_ascii=False, separators=(",", ":")).encode("utf-8")
+        payloads.append(payload)
+        _check(lib.render_harness_apply_object(payload, len(payload), flags), "apply_object")
+    ui_hash = ctypes.c_uint32()
+    arena_used = lib.render_harness_arena_used()
+    _check(lib.render_harness_save(ctypes.byref(ui_hash)), "render_harness_save")
+    if ui_hash.value != _ui_hash(payloads):
+        raise SystemExit(f"[render] saved UI hash {ui_hash.value:08x} != {_ui_hash(payloads):08x}")
+    print(f"h{height}.save: arena_bytes={arena_used} -> {lib.render_harness_arena_used()} "
+          "(static texts moved to flash)")
+    stats = HarnessStats()
+    _check(lib.render_harness_run(0, ctypes.byref(stats)), "render_harness_run")
+    yield "initial", stats, _framebuffer_rows(lib, height)
+    _check(lib.render_harness_input(UI_BUTTON_DOWN), "render_harness_input")
+    stats = HarnessStats()
+    _check(lib.render_harness_run(SCENE_SETTLE_MS, ctypes.byref(stats)), "render_harness_run")
+    yield "down", stats, _framebuffer_rows(lib, height)
+    _check(lib.render_harness_restore(), "render_harness_restore")
+    stats = HarnessStats()
+    _check(lib.render_harness_run(0, ctypes.byref(stats)), "render_harness_run")
+    yield "restored", stats, _framebuffer_rows(lib, height)
+
+
+def _diff_summary(expect, actual):
+    diffs = [(y, x) for y in range(min(len(expect), len(actual)))
+             for x in range(PANEL_WIDTH) if expect[y][x] != actual[y][x]]
+    if len(expect) != len(actual):
+        return f"height {len(actual)} != golden {len(expect)}"
+    return f"{len(diffs)} pixels differ, first at x={diffs[0][1]} y={diffs[0][0]}"
+
+
+def main():
+    ap = argparse.ArgumentParser(add_help=True)
+    ap.add_argument("input", help="nested (long-key) JSON file")
+    ap.add_argument("--height", type=int, choices=[32, 64], action="append",
+                    help="panel height (repeatable; default 32 and 64)")
+    ap.add_argument("--update", action="store_true",
+                    help="rewrite golden images and the frame cost limits")
+    ap.add_argument("--out", help="directory to write the rendered PBM files into")
+    args = ap.parse_args()
+
+    conv = _load_converter()
+    lib = _load_harness(conv)
+    input_path = Path(args.input)
+    stem = input_path.stem
+    data_dir = input_path.parent
+    cost_path = data_dir / f"{stem}.frame_cost.json"
+    limits = {}
+    if cost_path.exists():
+        with open(cost_path, "r", encoding="utf-8") as f:
+            limits = json.load(f)
+    measured = {}
+    failures = []
+    for height in args.height or [32, 64]:
+        for scene, stats, rows in _render_scenes(conv, lib, input_path, height):
+            key = f"h{height}.{scene}"
+            instr = "n/a" if stats.tile_instr < 0 else str(stats.tile_instr)
+            print(f"{key}: tile_calls={stats.tile_calls} i2c_xfers={stats.i2c_xfers} "
+                  f"i2c_bytes={stats.i2c_bytes} data_bytes={stats.data_bytes} tile_instr={instr}")
+            pbm = _pbm_text(rows)
+            if args.out:
+                Path(args.out).mkdir(parents=True, exist_ok=True)
+                (Path(args.out) / f"{stem}.{key}.pbm").write_text(pbm, encoding="ascii")
+            if scene in SCENE_GOLDEN:
+                golden = data_dir / f"{stem}.h{height}.{SCENE_GOLDEN[scene]}.pbm"
+                if args.update:
+                    continue
+            else:
+                golden = data_dir / f"{stem}.{key}.pbm"
+                measured[key] = {k: getattr(stats, k) for k in COST_KEYS}
+            if args.update:
+                golden.write_text(pbm, encoding="ascii")
+                continue
+            if not golden.exists():
+                failures.append(f"{key}: missing golden {golden} (run with --update)")
+            elif _pbm_rows(golden.read_text(encoding="ascii")) != rows:
+                failures.append(f"{key}: image mismatch, "
+                                + _diff_summary(_pbm_rows(golden.read_text(encoding="ascii")), rows))
+            for k in COST_KEYS:
+                limit = limits.get(key, {}).get(k)
+                if limit is not None and key in measured and measured[key][k] > limit:
+                    failures.append(f"{key}: {k} {measured[key][k]} exceeds limit {limit}")
+    if args.update:
+        limits.update(measured)
+        with open(cost_path, "w", encoding="utf-8") as f:
+            json.dump(limits, f, indent=2, sort_keys=True)
+            f.write("\n")
+        return 0
+    for msg in failures:
+        print(f"FAIL {msg}", file=sys.stderr)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
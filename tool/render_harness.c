@@ -0,0 +1,344 @@
+/**
+ * @file render_harness.c
+ * @brief Host render harness: the real renderer and SSD1306 driver streaming into an
+ *        emulated panel, with per-frame cost counters.
+ *
+ * Built as a shared library by tool/render_golden.py. The I2C stub decodes every
+ * transaction the way the controller does (control bytes, address window, horizontal
+ * addressing, display start line), so the captured image is what the panel shows and
+ * the byte counts are what the bus carries. Transfers complete on the next bus poll
+ * through the driver's transfer-complete hook, as the DMA interrupt would. The flash store
+ * is the RAM-backed host build, so a saved UI survives render_harness_restore().
+ */
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "i2c_custom.h"
+#include "ssd1306_driver.h"
+#include "status_codes.h"
+#include "ui_persist.h"
+#include "ui_protocol.h"
+
+#define HARNESS_RAM_PAGES 8u
+#define HARNESS_RAM_ROWS 64u
+#define HARNESS_SETTLE_STEPS 100000
+
+/** Per-frame cost counters (layout mirrored by render_golden.py). */
+typedef struct {
+  uint32_t tile_calls;  /* page callbacks run */
+  uint32_t i2c_xfers;   /* I2C transactions */
+  uint32_t i2c_bytes;   /* bytes on the bus after the address byte, control bytes included */
+  uint32_t data_bytes;  /* GDDRAM bytes written */
+  int64_t  tile_instr;  /* host instructions retired in page callbacks, -1 if unavailable */
+} render_harness_stats_t;
+
+/** Emulated SSD1306 controller state (horizontal addressing mode only). */
+typedef struct {
+  uint8_t ram[HARNESS_RAM_PAGES][SSD1306_WIDTH];
+  uint8_t start_line;
+  uint8_t col_start, col_end, page_start, page_end;
+  uint8_t col, page;
+  uint8_t cmd; /* command awaiting arguments */
+  uint8_t args[2];
+  uint8_t arg_count;
+  uint8_t arg_need;
+} harness_panel_t;
+
+static harness_panel_t        g_panel;
+static render_harness_stats_t g_stats;
+static uint32_t               g_now_ms;
+static void (*g_tx_done_cb)(i2c_err_t status);
+static uint8_t g_tx_pending;
+static int     g_instr_fd = -1;
+
+/* ---- Hardware and platform stubs ---- */
+
+uint32_t get_system_time_ms(void)
+{
+  return g_now_ms;
+}
+
+void debug_log_event(uint8_t type, uint8_t value)
+{
+  (void) type;
+  (void) value;
+}
+
+void debug_led_process(void) {}
+
+void spi_slave_tx_dma_start(const uint8_t* buffer, uint16_t length)
+{
+  (void) buffer;
+  (void) length;
+}
+
+int spi_slave_tx_dma_is_complete(void)
+{
+  return 1;
+}
+
+i2c_err_t i2c_init(i2c_device_t* dev)
+{
+  (void) dev;
+  return I2C_OK;
+}
+
+void i2c_set_tx_done_callback(void (*callback)(i2c_err_t status))
+{
+  g_tx_done_cb = callback;
+}
+
+int i2c_tx_dma_busy(void)
+{
+  if (g_tx_pending != 0u) {
+    g_tx_pending = 0u;
+    if (g_tx_done_cb) {
+      g_tx_done_cb(I2C_OK);
+    }
+  }
+  return g_tx_pending;
+}
+
+/** Number of argument bytes following an SSD1306 command byte. */
+static uint8_t harness_arg_count(uint8_t cmd)
+{
+  switch (cmd) {
+    case SSD1306_CMD_SET_COL_ADDR:
+    case SSD1306_CMD_SET_PAGE_ADDR:
+      return 2u;
+    case SSD1306_CMD_SET_DISPLAY_CLOCK_DIV:
+    case SSD1306_CMD_SET_MULTIPLEX:
+    case SSD1306_CMD_SET_DISPLAY_OFFSET:
+    case SSD1306_CMD_CHARGE_PUMP:
+    case SSD1306_CMD_MEMORY_MODE:
+    case SSD1306_CMD_SET_COMPINS:
+    case SSD1306_CMD_SET_CONTRAST:
+    case SSD1306_CMD_SET_PRECHARGE:
+    case SSD1306_CMD_SET_VCOM_DETECT:
+      return 1u;
+    default:
+      return 0u;
+  }
+}
+
+static void harness_panel_command(uint8_t byte)
+{
+  harness_panel_t* p = &g_panel;
+  if (p->arg_need != 0u) {
+    p->args[p->arg_count++] = byte;
+    if (p->arg_count < p->arg_need) {
+      return;
+    }
+    p->arg_need = 0u;
+    if (p->cmd == SSD1306_CMD_SET_COL_ADDR) {
+      p->col_start = p->args[0];
+      p->col_end   = p->args[1];
+      p->col       = p->col_start;
+    } else if (p->cmd == SSD1306_CMD_SET_PAGE_ADDR) {
+      p->page_start = p->args[0];
+      p->page_end   = p->args[1];
+      p->page       = p->page_start;
+    }
+    return;
+  }
+  if (byte >= SSD1306_CMD_SET_START_LINE_0 && byte <= 0x7Fu) {
+    p->start_line = (uint8_t) (byte & 0x3Fu);
+    return;
+  }
+  p->cmd       = byte;
+  p->arg_count = 0u;
+  p->arg_need  = harness_arg_count(byte);
+}
+
+static void harness_panel_data(uint8_t byte)
+{
+  harness_panel_t* p = &g_panel;
+  p->ram[p->page & 7u][p->col & 0x7Fu] = byte;
+  g_stats.data_bytes++;
+  if (p->col >= p->col_end) {
+    p->col  = p->col_start;
+    p->page = (p->page >= p->page_end) ? p->page_start : (uint8_t) (p->page + 1u);
+  } else {
+    p->col++;
+  }
+}
+
+/** Decode one I2C transaction: control bytes with Co=1 carry a single byte each. */
+i2c_err_t i2c_write_raw_dma(const i2c_device_t* dev, const uint8_t* buf, const size_t len)
+{
+  (void) dev;
+  size_t i = 0;
+  while (i < len) {
+    uint8_t control = buf[i++];
+    size_t  end     = (control & 0x80u) ? i + 1u : len;
+    for (; i < end && i < len; i++) {
+      if (control & 0x40u) {
+        harness_panel_data(buf[i]);
+      } else {
+        harness_panel_command(buf[i]);
+      }
+    }
+  }
+  g_stats.i2c_xfers++;
+  g_stats.i2c_bytes += (uint32_t) len;
+  g_tx_pending = 1u;
+  return I2C_OK;
+}
+
+/* ---- Instruction counter ---- */
+
+/** Open a user-space instruction counter for this thread (left at -1 where unsupported). */
+static void harness_instr_open(void)
+{
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  if (g_instr_fd >= 0) {
+    return;
+  }
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled       = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+  g_instr_fd          = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/** Page callback wrapper: count the call and the instructions the renderer spends in it. */
+static void harness_tile(uint8_t tile_y)
+{
+  g_stats.tile_calls++;
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  if (g_instr_fd >= 0) {
+    uint64_t count = 0u;
+    ioctl(g_instr_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(g_instr_fd, PERF_EVENT_IOC_ENABLE, 0);
+    render_screen_tile(tile_y);
+    ioctl(g_instr_fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(g_instr_fd, &count, sizeof(count)) == (ssize_t) sizeof(count)) {
+      g_stats.tile_instr += (int64_t) count;
+    }
+    return;
+  }
+#endif
+  render_screen_tile(tile_y);
+}
+
+/* ---- Harness API ---- */
+
+/** Reset the UI state, the emulated panel and the clock, then initialize the driver. */
+int render_harness_reset(uint8_t height)
+{
+  memset(&g_panel, 0, sizeof(g_panel));
+  g_now_ms     = 0u;
+  g_tx_pending = 0u;
+  harness_instr_open();
+  protocol_reset_state();
+  int r = ssd1306_init();
+  if (r == RES_OK) {
+    r = ssd1306_set_height(height);
+  }
+  ssd1306_render_async_set_frame_callback(render_frame_begin);
+  return r;
+}
+
+/** Apply one flat JSON element object (same path as SPI_CMD_JSON). */
+int render_harness_apply_object(const char* buf, uint16_t len, uint8_t flags)
+{
+  if (len > 255u) {
+    return RES_BAD_LEN;
+  }
+  return protocol_apply_json_object(buf, (uint8_t) len, flags);
+}
+
+/** Write the committed UI to the flash stub (SPI_CMD_SAVE_UI); *ui_hash gets its hash. */
+int render_harness_save(uint32_t* ui_hash)
+{
+  int r = ui_persist_save();
+  (void) ui_persist_info(ui_hash);
+  return r;
+}
+
+/** Arena bytes in use (head tables and attributes plus runtime nodes). */
+uint16_t render_harness_arena_used(void)
+{
+  return (uint16_t) (g_protocol_state.runtime.head_used + g_protocol_state.runtime.used_tail);
+}
+
+/** Drop the UI state as a reset would, then bring it back from the flash stub as at boot. */
+int render_harness_restore(void)
+{
+  protocol_reset_state();
+  return ui_persist_restore();
+}
+
+/** Inject a button press (SPI_CMD_INPUT_EVENT). */
+int render_harness_input(uint8_t button)
+{
+  uint8_t payload[2] = {button, 0u};
+  return cmd_input_event(payload, 2u);
+}
+
+/**
+ * Run the main-loop steps for elapsed_ms of wall-clock time: animation ticks every
+ * PROTOCOL_ANIM_FRAME_MS and async rendering until the panel is idle. Counters cover
+ * every frame rendered in that time.
+ */
+int render_harness_run(uint16_t elapsed_ms, render_harness_stats_t* out)
+{
+  memset(&g_stats, 0, sizeof(g_stats));
+  g_stats.tile_instr = (g_instr_fd >= 0) ? 0 : -1;
+  uint32_t end_ms    = g_now_ms + elapsed_ms;
+  for (;;) {
+    protocol_tick_animations();
+    int settled = 0;
+    for (int step = 0; step < HARNESS_SETTLE_STEPS; step++) {
+      ssd1306_render_async_process();
+      if (g_render_requested) {
+        g_render_requested = 0;
+        ssd1306_render_async_start_or_request(harness_tile);
+      }
+      if (!ssd1306_render_async_busy() && !g_render_requested) {
+        settled = 1;
+        break;
+      }
+    }
+    if (!settled) {
+      return RES_INTERNAL;
+    }
+    if (g_now_ms >= end_ms) {
+      break;
+    }
+    g_now_ms += PROTOCOL_ANIM_FRAME_MS;
+  }
+  if (out) {
+    *out = g_stats;
+  }
+  return RES_OK;
+}
+
+/** Copy the panel image (8 pages of 128 column bytes, LSB = top row) as the viewer sees it. */
+void render_harness_framebuffer(uint8_t* out)
+{
+  for (uint8_t page = 0; page < HARNESS_RAM_PAGES; page++) {
+    for (uint8_t c = 0; c < SSD1306_WIDTH; c++) {
+      uint8_t byte = 0u;
+      for (uint8_t b = 0; b < 8u; b++) {
+        uint8_t row = (uint8_t) ((page * 8u + b + g_panel.start_line) & (HARNESS_RAM_ROWS - 1u));
+        if (g_panel.ram[row >> 3][c] & (1u << (row & 7u))) {
+          byte |= (uint8_t) (1u << b);
+        }
+      }
+      out[(uint16_t) page * SSD1306_WIDTH + c] = byte;
+    }
+  }
+}